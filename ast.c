@@ -1179,6 +1179,9 @@ symbol_xget_value(struct source_location location, struct symbol const* self)
     return NULL;
 }
 
+// Number of elements at which a symbol table starts maintaining an index.
+static size_t const SYMBOL_TABLE_INDEX_THRESHOLD = 16;
+
 struct symbol_table*
 symbol_table_new(struct symbol_table const* parent)
 {
@@ -1198,6 +1201,7 @@ symbol_table_freeze(struct symbol_table* self)
 
     freeze(self);
     sbuf_freeze(self->elements);
+    sbuf_freeze(self->index.elements);
 }
 
 void
@@ -1227,6 +1231,19 @@ symbol_table_insert(
     sbuf_push(
         self->elements,
         (struct symbol_table_element){.name = name, .symbol = symbol});
+
+    // Most block scopes hold only a handful of symbols, so the index is only
+    // built once a table grows past the point where a linear search is cheap.
+    size_t const count = sbuf_count(self->elements);
+    if (count == SYMBOL_TABLE_INDEX_THRESHOLD) {
+        for (size_t i = 0; i < count; ++i) {
+            pointer_map_assign(
+                &self->index, self->elements[i].name, self->elements[i].symbol);
+        }
+    }
+    else if (count > SYMBOL_TABLE_INDEX_THRESHOLD) {
+        pointer_map_assign(&self->index, name, symbol);
+    }
 }
 
 struct symbol const*
@@ -1251,6 +1268,15 @@ symbol_table_lookup_local(struct symbol_table const* self, char const* name)
     assert(self != NULL);
     assert(name != NULL);
 
+    if (sbuf_count(self->elements) >= SYMBOL_TABLE_INDEX_THRESHOLD) {
+        struct symbol const* const symbol =
+            pointer_map_lookup(&self->index, name);
+        if (symbol != NULL) {
+            symbol_get_mutable(symbol)->uses += 1;
+        }
+        return symbol;
+    }
+
     for (size_t i = sbuf_count(self->elements); i--;) {
         if (self->elements[i].name == name) {
             symbol_get_mutable(self->elements[i].symbol)->uses += 1;
@@ -2267,7 +2293,11 @@ value_clone(struct value const* self)
         return value_new_real(self->data.real);
     }
     case TYPE_FUNCTION: {
-        return value_new_function(self->data.function);
+        // The type of a function value converted to another function type
+        // differs from the type of the function itself.
+        struct value* const cloned = value_new_function(self->data.function);
+        cloned->type = self->type;
+        return cloned;
     }
     case TYPE_POINTER: {
         return value_new_pointer(self->type, self->data.pointer);
@@ -23,6 +23,10 @@ static bool debug = false;
 static unsigned indent = 0u;
 static struct function const* current_function = NULL;
 static struct stmt const* current_for_range_loop = NULL;
+// True if large aggregates are passed and returned indirectly (see
+// abi_is_indirect). Disabled when compiling an object file with -c, since
+// every function of the object file may then be called from C.
+static bool abi_indirect_aggregates = false;
 FILE* out = NULL;
 
 static char const*
@@ -39,10 +43,23 @@ mangle_name(char const* name);
 static char const*
 mangle_type(struct type const* type);
 static char const*
+mangle_type_uncached(struct type const* type);
+static char const*
 mangle_address(struct address const* address);
 static char const*
 mangle_symbol(struct symbol const* symbol);
 
+static bool
+abi_is_indirect(struct type const* type);
+static bool
+abi_function_type_has_indirect(struct type const* type);
+static bool
+abi_symbol_is_extern_function(struct symbol const* symbol);
+static char const*
+strgen_abi_parameters(struct type const* type, struct function const* function);
+static char const*
+mangle_abi_thunk(struct function const* function);
+
 static void
 indent_incr(void);
 static void
@@ -96,7 +113,13 @@ codegen_stmt_continue(struct stmt const* stmt);
 static void
 codegen_stmt_switch(struct stmt const* stmt);
 static void
+codegen_stmt_switch_native(struct stmt const* stmt);
+static void
 codegen_stmt_return(struct stmt const* stmt);
+static char const*
+strgen_return_object(void);
+static void
+codegen_return(void);
 static void
 codegen_stmt_assert(struct stmt const* stmt);
 static void
@@ -125,6 +148,12 @@ strgen_rvalue_cast(struct expr const* expr);
 static char const*
 strgen_rvalue_call(struct expr const* expr);
 static char const*
+strgen_call(struct expr const* expr, char const* sret);
+static struct value const*
+expr_constant_object(struct expr const* expr);
+static struct function const*
+call_devirtualized_function(struct expr const* expr);
+static char const*
 strgen_rvalue_access_index(struct expr const* expr);
 static char const*
 strgen_rvalue_access_slice(struct expr const* expr);
@@ -246,6 +275,13 @@ strgen_fmt(char const* fmt, ...)
     return new;
 }
 
+// Memoized identifiers produced by the mangle_* functions, so that each type
+// and static or local address is mangled once per compilation.
+static struct pointer_map mangled_types; // type => mangle_type
+static struct pointer_map mangled_types_recursive; // type => recursive name
+static struct pointer_map mangled_statics; // interned name => identifier
+static struct pointer_map mangled_locals; // interned name => identifier
+
 static char const*
 mangle(char const* cstr)
 {
@@ -559,7 +595,10 @@ mangle_name(char const* name)
 }
 
 static char const*
-mangle_type_recursive(struct type const* type)
+mangle_type_recursive(struct type const* type);
+
+static char const*
+mangle_type_recursive_uncached(struct type const* type)
 {
     assert(type != NULL);
 
@@ -616,11 +655,37 @@ mangle_type_recursive(struct type const* type)
     return mangle(type->name);
 }
 
+static char const*
+mangle_type_recursive(struct type const* type)
+{
+    assert(type != NULL);
+
+    char const* result = pointer_map_lookup(&mangled_types_recursive, type);
+    if (result == NULL) {
+        result = mangle_type_recursive_uncached(type);
+        pointer_map_insert(&mangled_types_recursive, type, result);
+    }
+    return result;
+}
+
 static char const*
 mangle_type(struct type const* type)
 {
     assert(type != NULL);
 
+    char const* result = pointer_map_lookup(&mangled_types, type);
+    if (result == NULL) {
+        result = mangle_type_uncached(type);
+        pointer_map_insert(&mangled_types, type, result);
+    }
+    return result;
+}
+
+static char const*
+mangle_type_uncached(struct type const* type)
+{
+    assert(type != NULL);
+
     if (type->kind != TYPE_VOID && type->size == 0) {
         return context()->interned.void_;
     }
@@ -629,7 +694,7 @@ mangle_type(struct type const* type)
         return context()->interned.void_;
     }
 
-    char const* const typename = mangle_type_recursive(type);
+    char const* const typename = mangle_type_recursive_uncached(type);
 
     // Type names such as "pointer_to_T" or "slice_of_T" are valid identifiers
     // in both C and Sunder. Add the mangle prefix to the type names generated
@@ -655,10 +720,22 @@ mangle_address(struct address const* address)
         // are used exclusively for symbols and static objects, and will always
         // have an offset of zero.
         assert(address->data.static_.offset == 0);
-        return mangle_name(address->data.static_.name);
+        char const* const name = address->data.static_.name;
+        char const* result = pointer_map_lookup(&mangled_statics, name);
+        if (result == NULL) {
+            result = mangle_name(name);
+            pointer_map_insert(&mangled_statics, name, result);
+        }
+        return result;
     }
     case ADDRESS_LOCAL: {
-        return strgen_fmt(MANGLE_PREFIX "%s", mangle(address->data.local.name));
+        char const* const name = address->data.local.name;
+        char const* result = pointer_map_lookup(&mangled_locals, name);
+        if (result == NULL) {
+            result = strgen_fmt(MANGLE_PREFIX "%s", mangle(name));
+            pointer_map_insert(&mangled_locals, name, result);
+        }
+        return result;
     }
     }
 
@@ -671,7 +748,13 @@ mangle_symbol(struct symbol const* symbol)
 {
     assert(symbol != NULL);
 
-    return mangle_address(symbol_xget_address(symbol));
+    struct address const* const address = symbol_xget_address(symbol);
+    if (address->kind == ADDRESS_LOCAL && address->data.local.is_parameter
+        && abi_is_indirect(symbol_xget_type(symbol))) {
+        // Parameter passed by pointer to a caller-owned copy.
+        return strgen_fmt("(*%s)", mangle_address(address));
+    }
+    return mangle_address(address);
 }
 
 static void
@@ -816,27 +899,15 @@ codegen_type_definition(struct type const* type)
         break;
     }
     case TYPE_FUNCTION: {
-        struct string* params = string_new(NULL, 0);
-        size_t params_written = 0;
-        sbuf(struct type const* const) parameter_types =
-            type->data.function.parameter_types;
-        for (size_t i = 0; i < sbuf_count(parameter_types); ++i) {
-            if (parameter_types[i]->size == 0) {
-                continue;
-            }
-            if (params_written != 0) {
-                string_append_cstr(params, ", ");
-            }
-            string_append_cstr(params, mangle_type(parameter_types[i]));
-            params_written += 1;
-        }
+        // Function values always refer to functions using the Sunder calling
+        // convention. Extern functions are referenced through ABI thunks.
+        struct type const* const return_type = type->data.function.return_type;
         appendln(
             "typedef %s (*%s)(%s); // %s",
-            mangle_type(type->data.function.return_type),
+            abi_is_indirect(return_type) ? "void" : mangle_type(return_type),
             mangle_type(type),
-            string_count(params) != 0 ? string_start(params) : "void",
+            strgen_abi_parameters(type, NULL),
             type->name);
-        string_del(params);
         break;
     }
     case TYPE_POINTER: {
@@ -870,8 +941,10 @@ codegen_type_definition(struct type const* type)
         break;
     }
     case TYPE_SLICE: {
+        // The temporary pointer type is freed below, so it must not be used
+        // as a key in the mangled name caches.
         struct type* const starttype = type_new_pointer(type->data.slice.base);
-        char const* const startname = mangle_type(starttype);
+        char const* const startname = mangle_type_uncached(starttype);
         xalloc(starttype, XALLOC_FREE);
         char const* const countname = mangle_type(context()->builtin.usize);
         char const* const typename = mangle_type(type);
@@ -1024,6 +1097,381 @@ codegen_static_object(struct symbol const* symbol)
         strgen_value(symbol_xget_value(NO_LOCATION, symbol)));
 }
 
+// Maximum number of expression nodes within the body of a function that is
+// automatically marked for inlining.
+#define TRIVIAL_FUNCTION_EXPR_BUDGET 16
+
+// Returns true if the expression contains no function calls and is composed
+// of at most `*budget` expression nodes, decrementing `*budget` by the number
+// of nodes visited.
+static bool
+expr_is_trivial(struct expr const* expr, size_t* budget)
+{
+    assert(budget != NULL);
+
+    if (expr == NULL) {
+        return true;
+    }
+    if (*budget == 0) {
+        return false;
+    }
+    *budget -= 1;
+
+    switch (expr->kind) {
+    case EXPR_SYMBOL: /* fallthrough */
+    case EXPR_VALUE: /* fallthrough */
+    case EXPR_BYTES: /* fallthrough */
+    case EXPR_SIZEOF: /* fallthrough */
+    case EXPR_ALIGNOF: {
+        return true;
+    }
+    case EXPR_ARRAY_LIST: {
+        sbuf(struct expr const* const) const elements =
+            expr->data.array_list.elements;
+        for (size_t i = 0; i < sbuf_count(elements); ++i) {
+            if (!expr_is_trivial(elements[i], budget)) {
+                return false;
+            }
+        }
+        return expr_is_trivial(expr->data.array_list.ellipsis, budget);
+    }
+    case EXPR_SLICE_LIST: {
+        sbuf(struct expr const* const) const elements =
+            expr->data.slice_list.elements;
+        for (size_t i = 0; i < sbuf_count(elements); ++i) {
+            if (!expr_is_trivial(elements[i], budget)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case EXPR_SLICE: {
+        return expr_is_trivial(expr->data.slice.start, budget)
+            && expr_is_trivial(expr->data.slice.count, budget);
+    }
+    case EXPR_INIT: {
+        sbuf(struct member_variable_initializer const) const initializers =
+            expr->data.init.initializers;
+        for (size_t i = 0; i < sbuf_count(initializers); ++i) {
+            if (!expr_is_trivial(initializers[i].expr, budget)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case EXPR_CAST: {
+        return expr_is_trivial(expr->data.cast.expr, budget);
+    }
+    case EXPR_CALL: {
+        return false;
+    }
+    case EXPR_ACCESS_INDEX: {
+        return expr_is_trivial(expr->data.access_index.lhs, budget)
+            && expr_is_trivial(expr->data.access_index.idx, budget);
+    }
+    case EXPR_ACCESS_SLICE: {
+        return expr_is_trivial(expr->data.access_slice.lhs, budget)
+            && expr_is_trivial(expr->data.access_slice.begin, budget)
+            && expr_is_trivial(expr->data.access_slice.end, budget);
+    }
+    case EXPR_ACCESS_MEMBER_VARIABLE: {
+        return expr_is_trivial(
+            expr->data.access_member_variable.lhs, budget);
+    }
+    case EXPR_UNARY: {
+        return expr_is_trivial(expr->data.unary.rhs, budget);
+    }
+    case EXPR_BINARY: {
+        return expr_is_trivial(expr->data.binary.lhs, budget)
+            && expr_is_trivial(expr->data.binary.rhs, budget);
+    }
+    }
+
+    UNREACHABLE();
+    return false;
+}
+
+// Returns true if the statement is a guard of the form:
+//
+//      if <trivial condition> { <call to a cold function>; }
+//
+// Guards such as the state checks in std::result::value and
+// std::optional::value only call out on the failure path, so they do not
+// prevent the enclosing function from being inlined. The cold call is emitted
+// out of line by the C compiler, leaving a single branch at the call site.
+static bool
+stmt_is_cold_guard(struct stmt const* stmt, size_t* budget)
+{
+    assert(stmt != NULL);
+    assert(budget != NULL);
+
+    if (stmt->kind != STMT_IF) {
+        return false;
+    }
+    sbuf(struct conditional const) const conditionals =
+        stmt->data.if_.conditionals;
+    if (sbuf_count(conditionals) != 1 || conditionals[0].condition == NULL) {
+        return false;
+    }
+    if (!expr_is_trivial(conditionals[0].condition, budget)) {
+        return false;
+    }
+
+    sbuf(struct stmt const* const) const body = conditionals[0].body.stmts;
+    if (sbuf_count(body) != 1 || body[0]->kind != STMT_EXPR) {
+        return false;
+    }
+    struct expr const* const call = body[0]->data.expr;
+    if (call->kind != EXPR_CALL
+        || call->data.call.function->kind != EXPR_SYMBOL) {
+        return false;
+    }
+    struct symbol const* const symbol =
+        call->data.call.function->data.symbol;
+    if (symbol->kind != SYMBOL_FUNCTION) {
+        return false;
+    }
+    struct function const* const callee =
+        symbol_xget_value(NO_LOCATION, symbol)->data.function;
+    if ((callee->attributes & FUNCTION_ATTRIBUTE_COLD) == 0) {
+        return false;
+    }
+    sbuf(struct expr const* const) const arguments = call->data.call.arguments;
+    for (size_t i = 0; i < sbuf_count(arguments); ++i) {
+        if (!expr_is_trivial(arguments[i], budget)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if the function body is a single leaf statement, optionally
+// preceded by cold-path guards, small enough that the function should be
+// inlined into its callers, even when the C compiler is not optimizing. Such
+// functions only contain calls to cold functions, which are never
+// automatically inlined themselves, so inlining them cannot recurse.
+static bool
+function_is_trivial(struct function const* function)
+{
+    assert(function != NULL);
+
+    sbuf(struct stmt const* const) const stmts = function->body.stmts;
+    if (sbuf_count(stmts) == 0) {
+        return true;
+    }
+
+    size_t budget = TRIVIAL_FUNCTION_EXPR_BUDGET;
+    size_t const last = sbuf_count(stmts) - 1;
+    for (size_t i = 0; i < last; ++i) {
+        if (!stmt_is_cold_guard(stmts[i], &budget)) {
+            return false;
+        }
+    }
+
+    struct stmt const* const stmt = stmts[last];
+    switch (stmt->kind) {
+    case STMT_RETURN: {
+        return stmt->data.return_.defer == NULL
+            && expr_is_trivial(stmt->data.return_.expr, &budget);
+    }
+    case STMT_ASSIGN: {
+        return expr_is_trivial(stmt->data.assign.lhs, &budget)
+            && expr_is_trivial(stmt->data.assign.rhs, &budget);
+    }
+    case STMT_EXPR: {
+        return expr_is_trivial(stmt->data.expr, &budget);
+    }
+    default: {
+        return false;
+    }
+    }
+}
+
+// Aggregates larger than two machine words are passed to non-extern functions
+// by pointer to a caller-owned copy, and are returned from non-extern
+// functions through a caller-provided slot passed as a hidden first parameter
+// (sret). The caller copy is a fresh temporary, so the callee may read and
+// write the parameter through the pointer without observing aliasing that
+// would be absent when passing by value.
+//
+// This convention is only used when compiling a program. Functions of an
+// object file compiled with -c use the platform C ABI so that they may be
+// called from C.
+static bool
+abi_is_indirect(struct type const* type)
+{
+    assert(type != NULL);
+
+    if (!abi_indirect_aggregates) {
+        return false;
+    }
+
+    bool const is_aggregate = type->kind == TYPE_STRUCT
+        || type->kind == TYPE_UNION || type->kind == TYPE_ARRAY;
+    return is_aggregate && type->size != SIZEOF_UNSIZED
+        && type->size > 2 * context()->builtin.usize->size;
+}
+
+static bool
+abi_function_type_has_indirect(struct type const* type)
+{
+    assert(type != NULL);
+    assert(type->kind == TYPE_FUNCTION);
+
+    if (abi_is_indirect(type->data.function.return_type)) {
+        return true;
+    }
+    sbuf(struct type const* const) const parameter_types =
+        type->data.function.parameter_types;
+    for (size_t i = 0; i < sbuf_count(parameter_types); ++i) {
+        if (abi_is_indirect(parameter_types[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool
+abi_symbol_is_extern_function(struct symbol const* symbol)
+{
+    assert(symbol != NULL);
+
+    if (symbol->kind != SYMBOL_FUNCTION) {
+        return false;
+    }
+    struct value const* const value = symbol_xget_value(NO_LOCATION, symbol);
+    assert(value->type->kind == TYPE_FUNCTION);
+    return value->data.function->is_extern;
+}
+
+// Parameter list of a function of the provided type using the Sunder calling
+// convention. Parameter names are included if a function definition is
+// provided.
+static char const*
+strgen_abi_parameters(struct type const* type, struct function const* function)
+{
+    assert(type != NULL);
+    assert(type->kind == TYPE_FUNCTION);
+
+    struct string* const s = string_new(NULL, 0);
+    struct type const* const return_type = type->data.function.return_type;
+    if (abi_is_indirect(return_type)) {
+        string_append_fmt(s, "%s*", mangle_type(return_type));
+        if (function != NULL) {
+            string_append_cstr(s, " " MANGLE_PREFIX "sret");
+        }
+    }
+
+    sbuf(struct type const* const) const parameter_types =
+        type->data.function.parameter_types;
+    for (size_t i = 0; i < sbuf_count(parameter_types); ++i) {
+        if (parameter_types[i]->size == 0) {
+            continue;
+        }
+        if (string_count(s) != 0) {
+            string_append_cstr(s, ", ");
+        }
+        string_append_cstr(s, mangle_type(parameter_types[i]));
+        if (abi_is_indirect(parameter_types[i])) {
+            string_append_cstr(s, "*");
+        }
+        if (function != NULL) {
+            struct symbol const* const parameter =
+                function->symbol_parameters[i];
+            string_append_fmt(
+                s, " %s", mangle_address(symbol_xget_address(parameter)));
+        }
+    }
+
+    char const* const result = string_count(s) != 0
+        ? strgen(string_start(s), string_count(s))
+        : "void";
+    string_del(s);
+    return result;
+}
+
+static char const*
+mangle_abi_thunk(struct function const* function)
+{
+    assert(function != NULL);
+    assert(function->is_extern);
+
+    return strgen_fmt(
+        MANGLE_PREFIX "abi_thunk_%s",
+        mangle(function->address->data.static_.name));
+}
+
+// Generate a function using the Sunder calling convention that forwards to an
+// extern function using the C calling convention, used when the extern
+// function is referenced as a value.
+static void
+codegen_abi_thunk(struct function const* function)
+{
+    assert(function != NULL);
+    assert(function->is_extern);
+
+    struct type const* const type = function->type;
+    struct type const* const return_type = type->data.function.return_type;
+    sbuf(struct type const* const) const parameter_types =
+        type->data.function.parameter_types;
+
+    struct string* const params = string_new(NULL, 0);
+    struct string* const args = string_new(NULL, 0);
+    if (abi_is_indirect(return_type)) {
+        string_append_fmt(
+            params, "%s* %s", mangle_type(return_type), MANGLE_PREFIX "sret");
+    }
+    for (size_t i = 0; i < sbuf_count(parameter_types); ++i) {
+        if (parameter_types[i]->size == 0) {
+            continue;
+        }
+        bool const indirect = abi_is_indirect(parameter_types[i]);
+        if (string_count(params) != 0) {
+            string_append_cstr(params, ", ");
+        }
+        if (string_count(args) != 0) {
+            string_append_cstr(args, ", ");
+        }
+        string_append_fmt(
+            params,
+            "%s%s %sparameter_%zu",
+            mangle_type(parameter_types[i]),
+            indirect ? "*" : "",
+            MANGLE_PREFIX,
+            i);
+        string_append_fmt(
+            args, "%s%sparameter_%zu", indirect ? "*" : "", MANGLE_PREFIX, i);
+    }
+
+    char const* const callee = mangle(function->address->data.static_.name);
+    appendln(
+        "static %s",
+        abi_is_indirect(return_type) || return_type->size == 0
+            ? "void"
+            : mangle_type(return_type));
+    appendln(
+        "%s(%s)",
+        mangle_abi_thunk(function),
+        string_count(params) != 0 ? string_start(params) : "void");
+    appendln("{");
+    indent_incr();
+    if (abi_is_indirect(return_type)) {
+        appendli(
+            "*%s = %s(%s);", MANGLE_PREFIX "sret", callee, string_start(args));
+    }
+    else if (return_type->size == 0) {
+        appendli("%s(%s);", callee, string_start(args));
+    }
+    else {
+        appendli("return %s(%s);", callee, string_start(args));
+    }
+    indent_decr();
+    appendln("}");
+
+    string_del(params);
+    string_del(args);
+}
+
 static void
 codegen_static_function(struct symbol const* symbol, bool prototype)
 {
@@ -1039,9 +1487,14 @@ codegen_static_function(struct symbol const* symbol, bool prototype)
         return;
     }
 
-    struct string* params = string_new(NULL, 0);
-    size_t params_written = 0;
-    if (prototype) {
+    struct type const* const return_type =
+        function->type->data.function.return_type;
+    char const* returns = mangle_type(return_type);
+    char const* params = NULL;
+    if (function->is_extern) {
+        // Extern functions use the C calling convention of the platform, so
+        // all parameters and the return value are passed by value.
+        struct string* const s = string_new(NULL, 0);
         sbuf(struct type const* const) const parameter_types =
             function->type->data.function.parameter_types;
         for (size_t i = 0; i < sbuf_count(parameter_types); ++i) {
@@ -1049,40 +1502,49 @@ codegen_static_function(struct symbol const* symbol, bool prototype)
             if (type->size == 0) {
                 continue;
             }
-            if (params_written != 0) {
-                string_append_cstr(params, ", ");
+            if (string_count(s) != 0) {
+                string_append_cstr(s, ", ");
             }
-            string_append_cstr(params, mangle_type(type));
-            params_written += 1;
+            string_append_cstr(s, mangle_type(type));
         }
+        params = string_count(s) != 0 ? strgen(string_start(s), string_count(s))
+                                      : "void";
+        string_del(s);
     }
     else {
-        sbuf(struct symbol const* const) parameters =
-            function->symbol_parameters;
-        for (size_t i = 0; i < sbuf_count(parameters); ++i) {
-            if (symbol_xget_type(parameters[i])->size == 0) {
-                continue;
-            }
-            if (params_written != 0) {
-                string_append_cstr(params, ", ");
-            }
-            string_append_cstr(
-                params, mangle_type(symbol_xget_type(parameters[i])));
-            string_append_cstr(params, " ");
-            string_append_cstr(params, mangle_symbol(parameters[i]));
-            params_written += 1;
-        }
+        returns = abi_is_indirect(return_type) ? "void" : returns;
+        params = strgen_abi_parameters(
+            function->type, prototype ? NULL : function);
+    }
+
+    unsigned attributes = function->attributes;
+    bool const auto_inline_allowed =
+        (attributes & (FUNCTION_ATTRIBUTE_NOINLINE | FUNCTION_ATTRIBUTE_COLD))
+        == 0;
+    if (!function->is_extern && auto_inline_allowed
+        && function_is_trivial(function)) {
+        attributes |= FUNCTION_ATTRIBUTE_INLINE;
+    }
+    if (attributes & FUNCTION_ATTRIBUTE_INLINE) {
+        append("__SUNDER_FUNCTION_INLINE ");
+    }
+    if (attributes & FUNCTION_ATTRIBUTE_NOINLINE) {
+        append("__SUNDER_FUNCTION_NOINLINE ");
+    }
+    if (attributes & FUNCTION_ATTRIBUTE_HOT) {
+        append("__SUNDER_FUNCTION_HOT ");
+    }
+    if (attributes & FUNCTION_ATTRIBUTE_COLD) {
+        append("__SUNDER_FUNCTION_COLD ");
     }
 
     append(
         "%s%c%s(%s)",
-        mangle_type(function->type->data.function.return_type),
+        returns,
         (prototype ? ' ' : '\n'),
         ((function->is_extern ? mangle : mangle_name)(
             function->address->data.static_.name)),
-        params_written != 0 ? string_start(params) : "void");
-
-    string_del(params);
+        params);
 
     if (prototype) {
         appendln(";");
@@ -1122,9 +1584,13 @@ strgen_value(struct value const* value)
     case TYPE_U32: /* fallthrough */
     case TYPE_U64: /* fallthrough */
     case TYPE_USIZE: {
-        char* const cstr = bigint_to_new_cstr(value->data.integer);
-        string_append_fmt(s, "(%s)%sULL", mangle_type(value->type), cstr);
-        xalloc(cstr, XALLOC_FREE);
+        // Sized integer values always fit within a uintmax_t, so they are
+        // printed directly without a decimal string round trip.
+        uintmax_t umax = 0;
+        int const err = bigint_to_umax(&umax, value->data.integer);
+        assert(err == 0);
+        (void)err;
+        string_append_fmt(s, "(%s)%juULL", mangle_type(value->type), umax);
         break;
     }
     case TYPE_S8: /* fallthrough */
@@ -1132,25 +1598,22 @@ strgen_value(struct value const* value)
     case TYPE_S32: /* fallthrough */
     case TYPE_S64: /* fallthrough */
     case TYPE_SSIZE: {
-        char* const cstr = bigint_to_new_cstr(value->data.integer);
+        intmax_t smax = 0;
+        int const err = bigint_to_smax(&smax, value->data.integer);
+        assert(err == 0);
+        (void)err;
         struct bigint const* const min = value->type->data.integer.min;
         if (bigint_cmp(value->data.integer, min) == 0) {
-            struct bigint* const tmp = bigint_new(value->data.integer);
-            bigint_add(tmp, tmp, BIGINT_POS_ONE);
-            char* const tmp_cstr = bigint_to_new_cstr(tmp);
             string_append_fmt(
                 s,
-                "/* %s */((%s)%sLL - 1)",
-                cstr,
+                "/* %jd */((%s)%jdLL - 1)",
+                smax,
                 mangle_type(value->type),
-                tmp_cstr);
-            xalloc(tmp_cstr, XALLOC_FREE);
-            bigint_del(tmp);
+                smax + 1);
         }
         else {
-            string_append_fmt(s, "(%s)%sLL", mangle_type(value->type), cstr);
+            string_append_fmt(s, "(%s)%jdLL", mangle_type(value->type), smax);
         }
-        xalloc(cstr, XALLOC_FREE);
         break;
     }
     case TYPE_INTEGER: {
@@ -1260,6 +1723,12 @@ strgen_value(struct value const* value)
         //
         // will be called with the same arguments and return value location in
         // the same registers and/or offsets within the called stack frame.
+        struct function const* const function = value->data.function;
+        if (function->is_extern
+            && abi_function_type_has_indirect(function->type)) {
+            string_append_fmt(s, "(void*)%s", mangle_abi_thunk(function));
+            break;
+        }
         string_append_fmt(s, "(void*)%s", mangle_address(address));
         break;
     }
@@ -1611,6 +2080,11 @@ codegen_block(struct block const* block)
         if (locals[i].name == context()->interned.return_) {
             assert(!generate_final_return);
             generate_final_return = true;
+            if (abi_is_indirect(type)) {
+                // The return value is written directly into the slot
+                // provided by the caller.
+                continue;
+            }
         }
 
         appendli("// var %s: %s", locals[i].name, type->name);
@@ -1630,7 +2104,7 @@ codegen_block(struct block const* block)
     codegen_defers(block->defer_begin, block->defer_end);
     // Generate final return.
     if (generate_final_return) {
-        appendli("return %s;", mangle_name("return"));
+        codegen_return();
     }
 
     indent_decr();
@@ -1758,6 +2232,60 @@ codegen_stmt_continue(struct stmt const* stmt)
     appendli("continue;");
 }
 
+// Returns the compile-time value of the case symbol of a switch case, or NULL
+// if the case is the `else` case or the case symbol does not have a known
+// compile-time integer value.
+static struct value const*
+switch_case_value(struct switch_case const* case_)
+{
+    assert(case_ != NULL);
+
+    struct symbol const* const symbol = case_->symbol;
+    if (symbol == NULL || symbol->kind != SYMBOL_CONSTANT) {
+        return NULL;
+    }
+
+    struct value const* const value = symbol->data.constant->value;
+    if (value == NULL) {
+        return NULL;
+    }
+    if (value->type->kind != TYPE_ENUM && !type_is_integer(value->type)) {
+        return NULL;
+    }
+    return value;
+}
+
+static bool
+switch_cases_share_body(
+    struct switch_case const* a, struct switch_case const* b)
+{
+    assert(a != NULL);
+    assert(b != NULL);
+
+    // Case symbols joined with `or` are resolved into separate switch cases
+    // that each hold a copy of the same block.
+    return a->body.symbol_table == b->body.symbol_table
+        && a->body.stmts == b->body.stmts;
+}
+
+// Returns true if every non-`else` case of the switch statement has a
+// compile-time integer value, in which case the switch statement may be
+// lowered into a C `switch` statement.
+static bool
+switch_is_native(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_SWITCH);
+
+    sbuf(struct switch_case const) const cases = stmt->data.switch_.cases;
+    for (size_t i = 0; i < sbuf_count(cases); ++i) {
+        if (cases[i].symbol != NULL && switch_case_value(&cases[i]) == NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static void
 codegen_stmt_switch(struct stmt const* stmt)
 {
@@ -1781,6 +2309,11 @@ codegen_stmt_switch(struct stmt const* stmt)
         return;
     }
 
+    if (switch_is_native(stmt)) {
+        codegen_stmt_switch_native(stmt);
+        return;
+    }
+
     appendli("{ /* BEGIN SWITCH */");
     appendli(
         "%s %s = %s;",
@@ -1806,37 +2339,158 @@ codegen_stmt_switch(struct stmt const* stmt)
     appendli("} /* END SWITCH */");
 }
 
+// Lower a switch statement into a C `switch` statement that dispatches to a
+// labeled block for each case. The case blocks are placed outside of the C
+// `switch` statement so that `break` statements within a case block continue
+// to refer to the innermost enclosing loop.
 static void
-codegen_stmt_return(struct stmt const* stmt)
+codegen_stmt_switch_native(struct stmt const* stmt)
 {
     assert(stmt != NULL);
-    assert(stmt->kind == STMT_RETURN);
+    assert(stmt->kind == STMT_SWITCH);
 
-    struct expr const* const expr = stmt->data.return_.expr;
-    if (expr != NULL) {
-        if (expr->type->size == 0) {
-            // Compute the expression result.
-            appendli("%s;", strgen_rvalue(stmt->data.return_.expr));
+    static unsigned long switch_count = 0;
+    unsigned long const id = switch_count++;
+
+    sbuf(struct switch_case const) const cases = stmt->data.switch_.cases;
+    size_t const cases_count = sbuf_count(cases);
+    // Index of the first case of the group of cases sharing the body of each
+    // case, i.e. the case whose label is used for the shared body.
+    size_t* const groups = xalloc(NULL, cases_count * sizeof(*groups));
+    // Whether each case is reachable. A case is unreachable if an earlier case
+    // has the same value, as the earliest matching case is always taken.
+    bool* const reachable = xalloc(NULL, cases_count * sizeof(*reachable));
+
+    for (size_t i = 0; i < cases_count; ++i) {
+        groups[i] = i;
+        if (i != 0 && switch_cases_share_body(&cases[i - 1], &cases[i])) {
+            groups[i] = groups[i - 1];
+        }
+
+        reachable[i] = true;
+        struct value const* const value = switch_case_value(&cases[i]);
+        for (size_t j = 0; value != NULL && j < i; ++j) {
+            struct value const* const other = switch_case_value(&cases[j]);
+            if (other != NULL
+                && bigint_cmp(value->data.integer, other->data.integer) == 0) {
+                reachable[i] = false;
+                break;
+            }
+        }
+    }
+
+    appendli("{ /* BEGIN SWITCH */");
+    appendli(
+        "%s %s = %s;",
+        mangle_type(stmt->data.switch_.expr->type),
+        MANGLE_PREFIX "switch_expr",
+        strgen_rvalue(stmt->data.switch_.expr));
+    appendli("switch (%s) {", MANGLE_PREFIX "switch_expr");
+    bool contains_else = false;
+    for (size_t i = 0; i < cases_count; ++i) {
+        if (!reachable[i]) {
+            continue;
+        }
+        if (cases[i].symbol == NULL) {
+            contains_else = true;
+            appendli("default:");
         }
         else {
-            // Compute and store the expression result.
+            appendli("case %s:", strgen_value(switch_case_value(&cases[i])));
+        }
+        bool is_group_end = true;
+        for (size_t j = i + 1; j < cases_count && groups[j] == groups[i]; ++j) {
+            if (reachable[j]) {
+                is_group_end = false;
+                break;
+            }
+        }
+        if (is_group_end) {
+            indent_incr();
             appendli(
-                "%s = %s;",
-                mangle_name("return"),
-                strgen_rvalue(stmt->data.return_.expr));
+                "goto %sswitch_%lu_case_%zu;", MANGLE_PREFIX, id, groups[i]);
+            indent_decr();
         }
     }
-
-    codegen_defers(stmt->data.return_.defer, NULL);
-
-    if (symbol_xget_type(current_function->symbol_return)->size != 0) {
-        appendli("return %s;", mangle_name("return"));
+    if (!contains_else) {
+        appendli("default:");
+        indent_incr();
+        appendli("goto %sswitch_%lu_end;", MANGLE_PREFIX, id);
+        indent_decr();
+    }
+    appendli("}");
+
+    for (size_t i = 0; i < cases_count; ++i) {
+        if (groups[i] != i) {
+            continue;
+        }
+        appendli("%sswitch_%lu_case_%zu:", MANGLE_PREFIX, id, i);
+        codegen_block(&cases[i].body);
+        appendli("goto %sswitch_%lu_end;", MANGLE_PREFIX, id);
+    }
+    appendli("%sswitch_%lu_end:;", MANGLE_PREFIX, id);
+    appendli("} /* END SWITCH */");
+
+    xalloc(groups, XALLOC_FREE);
+    xalloc(reachable, XALLOC_FREE);
+}
+
+static char const*
+strgen_return_object(void)
+{
+    assert(current_function != NULL);
+
+    if (abi_is_indirect(symbol_xget_type(current_function->symbol_return))) {
+        return "(*" MANGLE_PREFIX "sret)";
+    }
+    return mangle_name("return");
+}
+
+static void
+codegen_return(void)
+{
+    assert(current_function != NULL);
+
+    struct type const* const type =
+        symbol_xget_type(current_function->symbol_return);
+    if (type->size != 0 && !abi_is_indirect(type)) {
+        appendli("return %s;", mangle_name("return"));
     }
     else {
         appendli("return;");
     }
 }
 
+static void
+codegen_stmt_return(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_RETURN);
+
+    struct expr const* const expr = stmt->data.return_.expr;
+    if (expr != NULL) {
+        if (expr->type->size == 0) {
+            // Compute the expression result.
+            appendli("%s;", strgen_rvalue(stmt->data.return_.expr));
+        }
+        else if (abi_is_indirect(expr->type) && expr->kind == EXPR_CALL) {
+            // Forward the caller-provided return slot to the callee, which
+            // constructs the result in place.
+            appendli("%s;", strgen_call(expr, MANGLE_PREFIX "sret"));
+        }
+        else {
+            // Compute and store the expression result.
+            appendli(
+                "%s = %s;",
+                strgen_return_object(),
+                strgen_rvalue(stmt->data.return_.expr));
+        }
+    }
+
+    codegen_defers(stmt->data.return_.defer, NULL);
+    codegen_return();
+}
+
 static void
 codegen_stmt_assert(struct stmt const* stmt)
 {
@@ -2251,7 +2905,13 @@ strgen_rvalue_symbol(struct expr const* expr)
         return strgen_cstr("/* zero-sized symbol */(0)");
     }
 
-    return mangle_symbol(expr->data.symbol);
+    struct symbol const* const symbol = expr->data.symbol;
+    if (abi_symbol_is_extern_function(symbol)
+        && abi_function_type_has_indirect(symbol_xget_type(symbol))) {
+        return mangle_abi_thunk(
+            symbol_xget_value(NO_LOCATION, symbol)->data.function);
+    }
+    return mangle_symbol(symbol);
 }
 
 static char const*
@@ -2598,14 +3258,128 @@ strgen_rvalue_cast(struct expr const* expr)
     return strgen_fmt("(%s)%s", mangle_type(expr->type), rvalue);
 }
 
+// Returns the compile-time value of an lvalue expression designating a static
+// constant object or a member of one, or NULL if the expression does not
+// designate a constant object.
+static struct value const*
+expr_constant_object(struct expr const* expr)
+{
+    assert(expr != NULL);
+
+    switch (expr->kind) {
+    case EXPR_SYMBOL: {
+        struct symbol const* const symbol = expr->data.symbol;
+        if (symbol->kind != SYMBOL_CONSTANT
+            || symbol_xget_address(symbol)->kind != ADDRESS_STATIC) {
+            return NULL;
+        }
+        return symbol->data.constant->value;
+    }
+    case EXPR_ACCESS_MEMBER_VARIABLE: {
+        struct value const* const lhs =
+            expr_constant_object(expr->data.access_member_variable.lhs);
+        if (lhs == NULL || lhs->type->kind != TYPE_STRUCT) {
+            return NULL;
+        }
+        return value_get_member_value(
+            expr->location,
+            lhs,
+            expr->data.access_member_variable.member_variable->name);
+    }
+    default: {
+        return NULL;
+    }
+    }
+}
+
+// Returns the function targeted by a call expression if the callee is a
+// function loaded from a constant object, such as a member of an interface
+// itable declared with `let`, so that the call may be emitted as a direct call
+// rather than an indirect call through a function pointer. Returns NULL if
+// the call cannot be devirtualized.
+static struct function const*
+call_devirtualized_function(struct expr const* expr)
+{
+    assert(expr != NULL);
+    assert(expr->kind == EXPR_CALL);
+
+    struct value const* const callee =
+        expr_constant_object(expr->data.call.function);
+    if (callee == NULL || callee->type->kind != TYPE_FUNCTION) {
+        return NULL;
+    }
+    struct function const* const function = callee->data.function;
+    if (function->is_extern) {
+        return NULL;
+    }
+
+    // Function values may be implicitly cast between function types differing
+    // only in pointer parameter and return types (e.g. `*T` to `*any`). Any
+    // other difference prevents devirtualization.
+    struct type const* const call_type = expr->data.call.function->type;
+    struct type const* const function_type = function->type;
+    sbuf(struct type const* const) const call_parameter_types =
+        call_type->data.function.parameter_types;
+    sbuf(struct type const* const) const function_parameter_types =
+        function_type->data.function.parameter_types;
+    if (sbuf_count(call_parameter_types)
+        != sbuf_count(function_parameter_types)) {
+        return NULL;
+    }
+    for (size_t i = 0; i < sbuf_count(call_parameter_types); ++i) {
+        struct type const* const a = call_parameter_types[i];
+        struct type const* const b = function_parameter_types[i];
+        if (a != b && (a->kind != TYPE_POINTER || b->kind != TYPE_POINTER)) {
+            return NULL;
+        }
+    }
+    struct type const* const a = call_type->data.function.return_type;
+    struct type const* const b = function_type->data.function.return_type;
+    if (a != b && (a->kind != TYPE_POINTER || b->kind != TYPE_POINTER)) {
+        return NULL;
+    }
+
+    return function;
+}
+
 static char const*
 strgen_rvalue_call(struct expr const* expr)
 {
     assert(expr != NULL);
     assert(expr->kind == EXPR_CALL);
 
+    return strgen_call(expr, NULL);
+}
+
+// Generate a function call. If `sret` is non-NULL, then the call must return
+// an aggregate passed indirectly, the result is stored into the object pointed
+// to by `sret`, and the generated expression has no value.
+static char const*
+strgen_call(struct expr const* expr, char const* sret)
+{
+    assert(expr != NULL);
+    assert(expr->kind == EXPR_CALL);
+
     struct expr const* const function = expr->data.call.function;
     sbuf(struct expr const* const) const arguments = expr->data.call.arguments;
+    assert(function->type->kind == TYPE_FUNCTION);
+    struct type const* const return_type =
+        function->type->data.function.return_type;
+    assert(sret == NULL || abi_is_indirect(return_type));
+
+    // Direct calls to extern functions use the C calling convention. All
+    // other calls use the Sunder calling convention.
+    bool const is_extern = function->kind == EXPR_SYMBOL
+        && abi_symbol_is_extern_function(function->data.symbol);
+    bool const indirect_return = !is_extern && abi_is_indirect(return_type);
+    struct function const* const direct =
+        is_extern ? NULL : call_devirtualized_function(expr);
+    sbuf(struct type const* const) const direct_parameter_types = direct != NULL
+        ? direct->type->data.function.parameter_types
+        : NULL;
+    struct type const* const direct_return_type = direct != NULL
+        ? direct->type->data.function.return_type
+        : return_type;
 
     struct string* const s = string_new_cstr("({");
 
@@ -2621,8 +3395,33 @@ strgen_rvalue_call(struct expr const* expr)
         string_append_fmt(s, "%s %s = %s; ", typename, initname, valuestr);
     }
 
-    string_append_fmt(s, "%s(", strgen_rvalue(function));
+    if (indirect_return && sret == NULL) {
+        string_append_fmt(
+            s, "%s %s; ", mangle_type(return_type), MANGLE_PREFIX "sret");
+    }
+    if (is_extern && sret != NULL) {
+        string_append_fmt(s, "*%s = ", sret);
+    }
+
+    char const* callee = is_extern ? mangle_symbol(function->data.symbol)
+                                   : strgen_rvalue(function);
+    if (direct != NULL) {
+        callee = mangle_address(direct->address);
+    }
+    if (direct_return_type != return_type) {
+        string_append_fmt(s, "(%s)", mangle_type(return_type));
+    }
+    string_append_fmt(s, "%s(", callee);
     size_t arguments_written = 0;
+    if (indirect_return) {
+        if (sret != NULL) {
+            string_append_cstr(s, sret);
+        }
+        else {
+            string_append_cstr(s, "&" MANGLE_PREFIX "sret");
+        }
+        arguments_written += 1;
+    }
     for (size_t i = 0; i < sbuf_count(arguments); ++i) {
         if (arguments[i]->type->size == 0) {
             continue;
@@ -2634,12 +3433,25 @@ strgen_rvalue_call(struct expr const* expr)
         char const* const local =
             strgen_fmt(MANGLE_PREFIX "argument_%zu", i + 1);
         char const* const initname = mangle_name(local);
+        if (!is_extern && abi_is_indirect(arguments[i]->type)) {
+            string_append_cstr(s, "&");
+        }
+        if (direct != NULL
+            && direct_parameter_types[i] != arguments[i]->type) {
+            string_append_fmt(
+                s, "(%s)", mangle_type(direct_parameter_types[i]));
+        }
         string_append_cstr(s, initname);
 
         arguments_written += 1;
     }
-    assert(function->type->kind == TYPE_FUNCTION);
-    if (function->type->data.function.return_type->size == 0) {
+    if (sret != NULL) {
+        string_append_cstr(s, ");");
+    }
+    else if (indirect_return) {
+        string_append_fmt(s, "); %s;", MANGLE_PREFIX "sret");
+    }
+    else if (return_type->size == 0) {
         string_append_cstr(s, "), /* zero-sized return */0;");
     }
     else {
@@ -3866,6 +4678,503 @@ codegen_defers(struct stmt const* begin, struct stmt const* end)
     }
 }
 
+// State of the reachability pass. Only static symbols and types reachable
+// from the program roots are emitted, so unused template instances and
+// `extend` helpers from imported modules never reach the C compiler.
+struct reachability {
+    // Static address name => static symbol, for every static symbol.
+    struct pointer_map statics;
+    // Pointer base type => pointer type, for every pointer type.
+    struct pointer_map pointers;
+    // Reachable static symbols.
+    struct pointer_map symbols;
+    // Reachable types.
+    struct pointer_map types;
+    // Reachable static symbols whose definitions have not been visited.
+    sbuf(struct symbol const*) worklist;
+};
+
+static void
+reach_type(struct reachability* self, struct type const* type);
+static void
+reach_address(struct reachability* self, struct address const* address);
+static void
+reach_symbol(struct reachability* self, struct symbol const* symbol);
+static void
+reach_value(struct reachability* self, struct value const* value);
+static void
+reach_expr(struct reachability* self, struct expr const* expr);
+static void
+reach_block(struct reachability* self, struct block const* block);
+static void
+reach_stmt(struct reachability* self, struct stmt const* stmt);
+
+static void
+reach_type(struct reachability* self, struct type const* type)
+{
+    assert(self != NULL);
+
+    if (type == NULL || !pointer_map_insert(&self->types, type, type)) {
+        return;
+    }
+
+    // Code generation may refer to the pointer type of any emitted type
+    // (e.g. the start of a slice or the address of an rvalue), so pointer
+    // types with an emitted base are always emitted.
+    reach_type(self, pointer_map_lookup(&self->pointers, type));
+
+    switch (type->kind) {
+    case TYPE_ANY: /* fallthrough */
+    case TYPE_VOID: /* fallthrough */
+    case TYPE_BOOL: /* fallthrough */
+    case TYPE_BYTE: /* fallthrough */
+    case TYPE_U8: /* fallthrough */
+    case TYPE_S8: /* fallthrough */
+    case TYPE_U16: /* fallthrough */
+    case TYPE_S16: /* fallthrough */
+    case TYPE_U32: /* fallthrough */
+    case TYPE_S32: /* fallthrough */
+    case TYPE_U64: /* fallthrough */
+    case TYPE_S64: /* fallthrough */
+    case TYPE_USIZE: /* fallthrough */
+    case TYPE_SSIZE: /* fallthrough */
+    case TYPE_INTEGER: /* fallthrough */
+    case TYPE_F32: /* fallthrough */
+    case TYPE_F64: /* fallthrough */
+    case TYPE_REAL: /* fallthrough */
+    case TYPE_EXTERN: {
+        return;
+    }
+    case TYPE_FUNCTION: {
+        sbuf(struct type const* const) const parameter_types =
+            type->data.function.parameter_types;
+        for (size_t i = 0; i < sbuf_count(parameter_types); ++i) {
+            reach_type(self, parameter_types[i]);
+        }
+        reach_type(self, type->data.function.return_type);
+        return;
+    }
+    case TYPE_POINTER: {
+        reach_type(self, type->data.pointer.base);
+        return;
+    }
+    case TYPE_ARRAY: {
+        reach_type(self, type->data.array.base);
+        return;
+    }
+    case TYPE_SLICE: {
+        reach_type(self, type->data.slice.base);
+        reach_type(self, context()->builtin.usize);
+        return;
+    }
+    case TYPE_STRUCT: {
+        sbuf(struct member_variable const) const mvars =
+            type->data.struct_.member_variables;
+        for (size_t i = 0; i < sbuf_count(mvars); ++i) {
+            reach_type(self, mvars[i].type);
+        }
+        return;
+    }
+    case TYPE_UNION: {
+        sbuf(struct member_variable const) const mvars =
+            type->data.union_.member_variables;
+        for (size_t i = 0; i < sbuf_count(mvars); ++i) {
+            reach_type(self, mvars[i].type);
+        }
+        return;
+    }
+    case TYPE_ENUM: {
+        reach_type(self, type->data.enum_.underlying_type);
+        return;
+    }
+    }
+
+    UNREACHABLE();
+}
+
+static void
+reach_address(struct reachability* self, struct address const* address)
+{
+    assert(self != NULL);
+
+    if (address == NULL || address->kind != ADDRESS_STATIC) {
+        return;
+    }
+
+    struct symbol const* const symbol =
+        pointer_map_lookup(&self->statics, address->data.static_.name);
+    if (symbol != NULL && pointer_map_insert(&self->symbols, symbol, symbol)) {
+        sbuf_push(self->worklist, symbol);
+    }
+}
+
+static void
+reach_symbol(struct reachability* self, struct symbol const* symbol)
+{
+    assert(self != NULL);
+
+    if (symbol == NULL) {
+        return;
+    }
+
+    switch (symbol->kind) {
+    case SYMBOL_VARIABLE: /* fallthrough */
+    case SYMBOL_CONSTANT: /* fallthrough */
+    case SYMBOL_FUNCTION: {
+        reach_type(self, symbol_xget_type(symbol));
+        reach_address(self, symbol_xget_address(symbol));
+        return;
+    }
+    case SYMBOL_TYPE: {
+        reach_type(self, symbol->data.type);
+        return;
+    }
+    case SYMBOL_TEMPLATE: /* fallthrough */
+    case SYMBOL_NAMESPACE: {
+        return;
+    }
+    }
+
+    UNREACHABLE();
+}
+
+static void
+reach_value(struct reachability* self, struct value const* value)
+{
+    assert(self != NULL);
+
+    if (value == NULL) {
+        return;
+    }
+
+    reach_type(self, value->type);
+    switch (value->type->kind) {
+    case TYPE_FUNCTION: {
+        reach_address(self, value->data.function->address);
+        return;
+    }
+    case TYPE_POINTER: {
+        reach_address(self, &value->data.pointer);
+        return;
+    }
+    case TYPE_ARRAY: {
+        sbuf(struct value* const) const elements =
+            value->data.array.elements;
+        for (size_t i = 0; i < sbuf_count(elements); ++i) {
+            reach_value(self, elements[i]);
+        }
+        reach_value(self, value->data.array.ellipsis);
+        return;
+    }
+    case TYPE_SLICE: {
+        reach_value(self, value->data.slice.start);
+        reach_value(self, value->data.slice.count);
+        return;
+    }
+    case TYPE_STRUCT: {
+        sbuf(struct value* const) const member_values =
+            value->data.struct_.member_values;
+        for (size_t i = 0; i < sbuf_count(member_values); ++i) {
+            reach_value(self, member_values[i]);
+        }
+        return;
+    }
+    case TYPE_UNION: {
+        reach_value(self, value->data.union_.member_value);
+        return;
+    }
+    default: {
+        return;
+    }
+    }
+}
+
+static void
+reach_expr(struct reachability* self, struct expr const* expr)
+{
+    assert(self != NULL);
+
+    if (expr == NULL) {
+        return;
+    }
+
+    reach_type(self, expr->type);
+    switch (expr->kind) {
+    case EXPR_SYMBOL: {
+        reach_symbol(self, expr->data.symbol);
+        return;
+    }
+    case EXPR_VALUE: {
+        reach_value(self, expr->data.value);
+        return;
+    }
+    case EXPR_BYTES: {
+        reach_symbol(self, expr->data.bytes.array_symbol);
+        reach_symbol(self, expr->data.bytes.slice_symbol);
+        return;
+    }
+    case EXPR_ARRAY_LIST: {
+        sbuf(struct expr const* const) const elements =
+            expr->data.array_list.elements;
+        for (size_t i = 0; i < sbuf_count(elements); ++i) {
+            reach_expr(self, elements[i]);
+        }
+        reach_expr(self, expr->data.array_list.ellipsis);
+        return;
+    }
+    case EXPR_SLICE_LIST: {
+        reach_symbol(self, expr->data.slice_list.array_symbol);
+        sbuf(struct expr const* const) const elements =
+            expr->data.slice_list.elements;
+        for (size_t i = 0; i < sbuf_count(elements); ++i) {
+            reach_expr(self, elements[i]);
+        }
+        return;
+    }
+    case EXPR_SLICE: {
+        reach_expr(self, expr->data.slice.start);
+        reach_expr(self, expr->data.slice.count);
+        return;
+    }
+    case EXPR_INIT: {
+        sbuf(struct member_variable_initializer const) const initializers =
+            expr->data.init.initializers;
+        for (size_t i = 0; i < sbuf_count(initializers); ++i) {
+            reach_expr(self, initializers[i].expr);
+        }
+        return;
+    }
+    case EXPR_CAST: {
+        reach_expr(self, expr->data.cast.expr);
+        return;
+    }
+    case EXPR_CALL: {
+        reach_expr(self, expr->data.call.function);
+        sbuf(struct expr const* const) const arguments =
+            expr->data.call.arguments;
+        for (size_t i = 0; i < sbuf_count(arguments); ++i) {
+            reach_expr(self, arguments[i]);
+        }
+        return;
+    }
+    case EXPR_ACCESS_INDEX: {
+        reach_expr(self, expr->data.access_index.lhs);
+        reach_expr(self, expr->data.access_index.idx);
+        return;
+    }
+    case EXPR_ACCESS_SLICE: {
+        reach_expr(self, expr->data.access_slice.lhs);
+        reach_expr(self, expr->data.access_slice.begin);
+        reach_expr(self, expr->data.access_slice.end);
+        return;
+    }
+    case EXPR_ACCESS_MEMBER_VARIABLE: {
+        reach_expr(self, expr->data.access_member_variable.lhs);
+        return;
+    }
+    case EXPR_SIZEOF: {
+        reach_type(self, expr->data.sizeof_.rhs);
+        return;
+    }
+    case EXPR_ALIGNOF: {
+        reach_type(self, expr->data.alignof_.rhs);
+        return;
+    }
+    case EXPR_UNARY: {
+        reach_expr(self, expr->data.unary.rhs);
+        reach_address(self, expr->data.unary.address);
+        return;
+    }
+    case EXPR_BINARY: {
+        reach_expr(self, expr->data.binary.lhs);
+        reach_expr(self, expr->data.binary.rhs);
+        return;
+    }
+    }
+
+    UNREACHABLE();
+}
+
+static void
+reach_block(struct reachability* self, struct block const* block)
+{
+    assert(self != NULL);
+    assert(block != NULL);
+
+    // Local variables are declared at the start of the block, so their types
+    // are reachable even if the variable is never referenced. Local constants
+    // are static symbols and only become reachable when referenced.
+    sbuf(struct symbol_table_element) locals = block->symbol_table->elements;
+    for (size_t i = 0; i < sbuf_count(locals); ++i) {
+        if (locals[i].symbol->kind == SYMBOL_VARIABLE) {
+            reach_type(self, symbol_xget_type(locals[i].symbol));
+        }
+    }
+    for (size_t i = 0; i < sbuf_count(block->stmts); ++i) {
+        reach_stmt(self, block->stmts[i]);
+    }
+}
+
+static void
+reach_stmt(struct reachability* self, struct stmt const* stmt)
+{
+    assert(self != NULL);
+    assert(stmt != NULL);
+
+    switch (stmt->kind) {
+    case STMT_DEFER: {
+        reach_block(self, &stmt->data.defer.body);
+        return;
+    }
+    case STMT_IF: {
+        sbuf(struct conditional const) const conditionals =
+            stmt->data.if_.conditionals;
+        for (size_t i = 0; i < sbuf_count(conditionals); ++i) {
+            reach_expr(self, conditionals[i].condition);
+            reach_block(self, &conditionals[i].body);
+        }
+        return;
+    }
+    case STMT_FOR_RANGE: {
+        reach_symbol(self, stmt->data.for_range.loop_variable);
+        reach_expr(self, stmt->data.for_range.begin);
+        reach_expr(self, stmt->data.for_range.end);
+        reach_block(self, &stmt->data.for_range.body);
+        return;
+    }
+    case STMT_FOR_EXPR: {
+        reach_expr(self, stmt->data.for_expr.expr);
+        reach_block(self, &stmt->data.for_expr.body);
+        return;
+    }
+    case STMT_BREAK: /* fallthrough */
+    case STMT_CONTINUE: {
+        return;
+    }
+    case STMT_SWITCH: {
+        reach_expr(self, stmt->data.switch_.expr);
+        struct switch_case const* const cases = stmt->data.switch_.cases;
+        for (size_t i = 0; i < sbuf_count(cases); ++i) {
+            reach_symbol(self, cases[i].symbol);
+            reach_block(self, &cases[i].body);
+        }
+        return;
+    }
+    case STMT_RETURN: {
+        reach_expr(self, stmt->data.return_.expr);
+        return;
+    }
+    case STMT_ASSERT: {
+        reach_expr(self, stmt->data.assert_.expr);
+        reach_symbol(self, stmt->data.assert_.array_symbol);
+        reach_symbol(self, stmt->data.assert_.slice_symbol);
+        return;
+    }
+    case STMT_ASSIGN: {
+        reach_expr(self, stmt->data.assign.lhs);
+        reach_expr(self, stmt->data.assign.rhs);
+        return;
+    }
+    case STMT_EXPR: {
+        reach_expr(self, stmt->data.expr);
+        return;
+    }
+    }
+
+    UNREACHABLE();
+}
+
+// Compute the static symbols and types reachable from the program roots.
+// When compiling an executable the only root is `main`. When compiling an
+// object file (-c) every static symbol outside of a template instance may be
+// referenced by other objects, so all such symbols are roots.
+static void
+reachability_init(struct reachability* self, bool opt_c)
+{
+    assert(self != NULL);
+
+    *self = (struct reachability){0};
+    sbuf(struct symbol const* const) const statics = context()->static_symbols;
+    for (size_t i = 0; i < sbuf_count(statics); ++i) {
+        struct address const* const address = symbol_xget_address(statics[i]);
+        assert(address->kind == ADDRESS_STATIC);
+        char const* const name = address->data.static_.name;
+        pointer_map_insert(&self->statics, name, statics[i]);
+    }
+    for (size_t i = 0; i < sbuf_count(context()->types); ++i) {
+        struct type const* const type = context()->types[i];
+        if (type->kind == TYPE_POINTER) {
+            pointer_map_insert(&self->pointers, type->data.pointer.base, type);
+        }
+    }
+
+    for (size_t i = 0; i < sbuf_count(statics); ++i) {
+        struct symbol const* const symbol = statics[i];
+        char const* const name = symbol_xget_address(symbol)->data.static_.name;
+        bool const is_root = opt_c
+            ? strstr(name, "[[") == NULL
+            : symbol->kind == SYMBOL_FUNCTION
+                && symbol->name == context()->interned.main
+                && name == context()->interned.main;
+        if (is_root) {
+            reach_symbol(self, symbol);
+        }
+    }
+
+    while (sbuf_count(self->worklist) != 0) {
+        struct symbol const* const symbol = sbuf_pop(self->worklist);
+        // Symbols reached through an address (e.g. a function value cast to
+        // a function type with different parameter types) are declared with
+        // their own type, which may not otherwise be reachable.
+        reach_type(self, symbol_xget_type(symbol));
+        if (symbol->kind == SYMBOL_FUNCTION) {
+            struct function const* const function =
+                symbol_xget_value(NO_LOCATION, symbol)->data.function;
+            if (function->is_extern) {
+                continue;
+            }
+            sbuf(struct symbol const* const) const parameters =
+                function->symbol_parameters;
+            for (size_t i = 0; i < sbuf_count(parameters); ++i) {
+                reach_symbol(self, parameters[i]);
+            }
+            reach_symbol(self, function->symbol_return);
+            reach_block(self, &function->body);
+            continue;
+        }
+
+        struct object const* const object = symbol->kind == SYMBOL_VARIABLE
+            ? symbol->data.variable
+            : symbol->data.constant;
+        reach_value(self, object->value);
+    }
+}
+
+static void
+reachability_fini(struct reachability* self)
+{
+    assert(self != NULL);
+
+    pointer_map_fini(&self->statics);
+    pointer_map_fini(&self->pointers);
+    pointer_map_fini(&self->symbols);
+    pointer_map_fini(&self->types);
+    sbuf_fini(self->worklist);
+}
+
+static bool
+reachability_has_symbol(
+    struct reachability const* self, struct symbol const* symbol)
+{
+    return pointer_map_lookup(&self->symbols, symbol) != NULL;
+}
+
+static bool
+reachability_has_type(struct reachability const* self, struct type const* type)
+{
+    return pointer_map_lookup(&self->types, type) != NULL;
+}
+
 void
 codegen(
     bool opt_c,
@@ -3880,6 +5189,7 @@ codegen(
     assert(opt_o != NULL);
 
     debug = opt_g;
+    abi_indirect_aggregates = !opt_c;
     struct string* const src_path = string_new_fmt("%s.tmp.c", opt_o);
 
     char const* const SUNDER_HOME = getenv("SUNDER_HOME");
@@ -3957,6 +5267,7 @@ codegen(
             sbuf_push(backend_argv, strgen_fmt("-L%s", opt_L[i]));
         }
         sbuf_push(backend_argv, "-lm");
+        sbuf_push(backend_argv, "-lpthread");
         for (size_t i = 0; i < sbuf_count(opt_l); ++i) {
             sbuf_push(backend_argv, strgen_fmt("-l%s", opt_l[i]));
         }
@@ -3988,21 +5299,44 @@ codegen(
         goto cleanup;
     }
 
-    // Check for duplicate static addresses amongst separate symbols.
+    // Check for duplicate static addresses amongst separate symbols. Mangled
+    // addresses are interned so that conflicts are found by hashing. Only the
+    // symbols whose mangled address conflicts with some other symbol are
+    // compared pairwise in order to produce diagnostics.
     struct static_symbol_mapping {
         struct symbol const* symbol;
-        char const* mangled_address;
+        char const* mangled_address; // interned
     };
     sbuf(struct static_symbol_mapping) static_symbol_mappings = NULL;
+    struct pointer_map mangled_addresses = {0}; // interned => interned
+    struct pointer_map conflicting_addresses = {0}; // interned => interned
     for (size_t i = 0; i < sbuf_count(context()->static_symbols); ++i) {
         struct symbol const* const symbol = context()->static_symbols[i];
         assert(symbol_xget_address(symbol)->kind == ADDRESS_STATIC);
+        char const* const mangled_address =
+            intern_cstr(mangle_address(symbol_xget_address(symbol)));
+        if (!pointer_map_insert(
+                &mangled_addresses, mangled_address, mangled_address)) {
+            pointer_map_insert(
+                &conflicting_addresses, mangled_address, mangled_address);
+        }
+    }
+    for (size_t i = 0; i < sbuf_count(context()->static_symbols); ++i) {
+        struct symbol const* const symbol = context()->static_symbols[i];
+        char const* const mangled_address =
+            intern_cstr(mangle_address(symbol_xget_address(symbol)));
+        if (pointer_map_lookup(&conflicting_addresses, mangled_address)
+            == NULL) {
+            continue;
+        }
         struct static_symbol_mapping const mapping = {
             .symbol = symbol,
-            .mangled_address = mangle_address(symbol_xget_address(symbol)),
+            .mangled_address = mangled_address,
         };
         sbuf_push(static_symbol_mappings, mapping);
     }
+    pointer_map_fini(&mangled_addresses);
+    pointer_map_fini(&conflicting_addresses);
     sbuf_freeze(static_symbol_mappings);
     for (size_t i = 0; i < sbuf_count(static_symbol_mappings); ++i) {
         struct static_symbol_mapping const m_i = static_symbol_mappings[i];
@@ -4012,7 +5346,7 @@ codegen(
             char const* const mangled_address_j = m_j.mangled_address;
             assert(mangled_address_i != NULL);
             assert(mangled_address_j != NULL);
-            if (0 != strcmp(mangled_address_i, mangled_address_j)) {
+            if (mangled_address_i != mangled_address_j) {
                 continue; // No mangled static address conflict.
             }
 
@@ -4052,31 +5386,59 @@ codegen(
         goto cleanup;
     }
 
+    struct reachability reachability;
+    reachability_init(&reachability, opt_c);
+
     appendln("#include \"sys.h\"");
     appendch('\n');
     // Generate forward type declarations.
     for (size_t i = 0; i < sbuf_count(context()->types); ++i) {
         struct type const* const type = context()->types[i];
-        codegen_type_declaration(type);
+        if (reachability_has_type(&reachability, type)) {
+            codegen_type_declaration(type);
+        }
     }
     // Generate type definitions.
     for (size_t i = 0; i < sbuf_count(context()->types); ++i) {
         struct type const* const type = context()->types[i];
-        codegen_type_definition(type);
+        if (reachability_has_type(&reachability, type)) {
+            codegen_type_definition(type);
+        }
     }
     appendch('\n');
     // Generate static function prototypes.
     for (size_t i = 0; i < sbuf_count(context()->static_symbols); ++i) {
         struct symbol const* const symbol = context()->static_symbols[i];
+        if (!reachability_has_symbol(&reachability, symbol)) {
+            continue;
+        }
         assert(symbol_xget_address(symbol)->kind == ADDRESS_STATIC);
         if (symbol->kind != SYMBOL_FUNCTION) {
             continue;
         }
         codegen_static_function(symbol, true);
     }
+    // Generate thunks for extern functions that may be referenced as values.
+    for (size_t i = 0; i < sbuf_count(context()->static_symbols); ++i) {
+        struct symbol const* const symbol = context()->static_symbols[i];
+        if (!reachability_has_symbol(&reachability, symbol)) {
+            continue;
+        }
+        if (!abi_symbol_is_extern_function(symbol)) {
+            continue;
+        }
+        struct function const* const function =
+            symbol_xget_value(NO_LOCATION, symbol)->data.function;
+        if (abi_function_type_has_indirect(function->type)) {
+            codegen_abi_thunk(function);
+        }
+    }
     // Generate static object definitions.
     for (size_t i = 0; i < sbuf_count(context()->static_symbols); ++i) {
         struct symbol const* const symbol = context()->static_symbols[i];
+        if (!reachability_has_symbol(&reachability, symbol)) {
+            continue;
+        }
         assert(symbol_xget_address(symbol)->kind == ADDRESS_STATIC);
         bool const is_static_object =
             symbol->kind == SYMBOL_VARIABLE || symbol->kind == SYMBOL_CONSTANT;
@@ -4088,6 +5450,9 @@ codegen(
     // Generate static function definitions.
     for (size_t i = 0; i < sbuf_count(context()->static_symbols); ++i) {
         struct symbol const* const symbol = context()->static_symbols[i];
+        if (!reachability_has_symbol(&reachability, symbol)) {
+            continue;
+        }
         assert(symbol_xget_address(symbol)->kind == ADDRESS_STATIC);
         if (symbol->kind != SYMBOL_FUNCTION) {
             continue;
@@ -4108,6 +5473,11 @@ codegen(
         indent_decr();
         appendln("}");
     }
+    reachability_fini(&reachability);
+    pointer_map_fini(&mangled_types);
+    pointer_map_fini(&mangled_types_recursive);
+    pointer_map_fini(&mangled_statics);
+    pointer_map_fini(&mangled_locals);
 
     (void)fclose(out);
 
@@ -130,7 +130,8 @@ cst_decl_new_function(
     struct cst_identifier const* template_parameters,
     struct cst_function_parameter const* const* function_parameters,
     struct cst_type const* return_type,
-    struct cst_block body)
+    struct cst_block body,
+    unsigned attributes)
 {
     assert(return_type != NULL);
 
@@ -144,6 +145,7 @@ cst_decl_new_function(
     self->data.function.function_parameters = function_parameters;
     self->data.function.return_type = return_type;
     self->data.function.body = body;
+    self->data.function.attributes = attributes;
     return self;
 }
 
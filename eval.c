@@ -7,6 +7,40 @@
 
 #include "sunder.h"
 
+// Maximum number of statements and loop iterations that may be executed while
+// evaluating a function call within a compile-time expression.
+#define EVAL_STEP_BUDGET (1ul << 22u)
+// Maximum depth of nested function calls within a compile-time expression.
+#define EVAL_CALL_DEPTH_MAX 256u
+
+// Local variable of a function evaluated at compile-time.
+struct eval_local {
+    struct symbol const* symbol;
+    struct value* value; // optional (NULL => uninit)
+};
+
+// Activation record of a function evaluated at compile-time.
+struct eval_frame {
+    struct function const* function;
+    sbuf(struct eval_local) locals;
+    struct value* return_value; // optional (NULL => no value returned)
+};
+
+// Control flow resulting from the evaluation of a statement.
+enum eval_flow {
+    EVAL_FLOW_NEXT,
+    EVAL_FLOW_BREAK,
+    EVAL_FLOW_CONTINUE,
+    EVAL_FLOW_RETURN,
+};
+
+// Optional (NULL => not evaluating a function body).
+static struct eval_frame* current_frame = NULL;
+static unsigned current_call_depth = 0;
+static unsigned long current_steps_remaining = 0;
+// Optional (NULL => not evaluating the body of a for-range loop).
+static struct stmt const* current_for_range_loop = NULL;
+
 static bool
 integer_is_out_of_range(struct type const* type, struct bigint const* res);
 static uint8_t* //sbuf
@@ -29,6 +63,8 @@ eval_rvalue_init(struct expr const* expr);
 static struct value*
 eval_rvalue_cast(struct expr const* expr);
 static struct value*
+eval_rvalue_call(struct expr const* expr);
+static struct value*
 eval_rvalue_access_index(struct expr const* expr);
 static struct value*
 eval_rvalue_access_slice(struct expr const* expr);
@@ -54,6 +90,39 @@ eval_lvalue_access_member_variable(struct expr const* expr);
 static struct value*
 eval_lvalue_unary(struct expr const* expr);
 
+static struct value* // optional (NULL => void)
+eval_call(struct expr const* expr);
+static void
+eval_step(struct source_location location);
+static enum eval_flow
+eval_block(struct block const* block);
+static void
+eval_defers(struct stmt const* begin, struct stmt const* end);
+static enum eval_flow
+eval_stmt(struct stmt const* stmt);
+static enum eval_flow
+eval_stmt_for_range(struct stmt const* stmt);
+static enum eval_flow
+eval_stmt_for_expr(struct stmt const* stmt);
+static enum eval_flow
+eval_stmt_switch(struct stmt const* stmt);
+static enum eval_flow
+eval_stmt_return(struct stmt const* stmt);
+static enum eval_flow
+eval_stmt_assign(struct stmt const* stmt);
+static bool
+eval_condition(struct expr const* expr);
+static bool
+eval_is_local(struct symbol const* symbol);
+static struct value**
+eval_local_slot(struct expr const* expr);
+static struct value const*
+eval_borrow(struct expr const* expr);
+static size_t
+eval_array_index(struct expr const* idx, struct type const* array_type);
+static struct value*
+eval_new_uninit(struct source_location location, struct type const* type);
+
 static bool
 integer_is_out_of_range(struct type const* type, struct bigint const* res)
 {
@@ -209,7 +278,7 @@ eval_rvalue(struct expr const* expr)
         return eval_rvalue_cast(expr);
     }
     case EXPR_CALL: {
-        fatal(expr->location, "constant expression contains function call");
+        return eval_rvalue_call(expr);
     }
     case EXPR_ACCESS_INDEX: {
         return eval_rvalue_access_index(expr);
@@ -247,6 +316,10 @@ eval_rvalue_symbol(struct expr const* expr)
     struct symbol const* const symbol = expr->data.symbol;
     enum symbol_kind const kind = symbol->kind;
 
+    if (eval_is_local(symbol)) {
+        return value_clone(eval_borrow(expr));
+    }
+
     if (kind == SYMBOL_CONSTANT || kind == SYMBOL_FUNCTION) {
         return value_clone(symbol_xget_value(expr->location, symbol));
     }
@@ -837,39 +910,35 @@ eval_rvalue_access_index(struct expr const* expr)
     assert(expr != NULL);
     assert(expr->kind == EXPR_ACCESS_INDEX);
 
-    struct value* const lhs = eval_rvalue(expr->data.access_index.lhs);
-    struct value* const idx = eval_rvalue(expr->data.access_index.idx);
-
-    assert(idx->type->kind == TYPE_USIZE);
-    struct bigint const* const idx_bigint = idx->data.integer;
-    size_t idx_uz = 0u;
-    if (bigint_to_uz(&idx_uz, idx_bigint)) {
-        fatal(
-            expr->data.access_index.idx->location,
-            "index out-of-range (received %s)",
-            bigint_to_new_cstr(idx_bigint));
-    }
-
-    if (lhs->type->kind == TYPE_ARRAY) {
-        if (idx_uz >= lhs->type->data.array.count) {
+    if (expr->data.access_index.lhs->type->kind == TYPE_ARRAY) {
+        // Elements of local and constant arrays are read in place rather than
+        // from a clone of the entire array.
+        size_t const idx_uz = eval_array_index(
+            expr->data.access_index.idx, expr->data.access_index.lhs->type);
+        struct value const* const borrowed =
+            eval_borrow(expr->data.access_index.lhs);
+        struct value* const lhs =
+            borrowed == NULL ? eval_rvalue(expr->data.access_index.lhs) : NULL;
+        struct value const* const array = borrowed != NULL ? borrowed : lhs;
+
+        sbuf(struct value*) const elements = array->data.array.elements;
+        struct value* const ellipsis = array->data.array.ellipsis;
+        assert(idx_uz < sbuf_count(elements) || ellipsis != NULL);
+        struct value const* const element =
+            idx_uz < sbuf_count(elements) ? elements[idx_uz] : ellipsis;
+        if (element == NULL) {
             fatal(
-                expr->data.access_index.idx->location,
-                "index out-of-bounds (array count is %ju, received %zu)",
-                lhs->type->data.array.count,
-                idx_uz);
+                expr->location,
+                "use of uninitialized array element in compile-time expression");
+        }
+        struct value* const res = value_clone(element);
+        if (lhs != NULL) {
+            value_del(lhs);
         }
-
-        sbuf(struct value*) const elements = lhs->data.array.elements;
-        struct value* const ellipsis = lhs->data.array.ellipsis;
-        assert(idx_uz < sbuf_count(elements) || ellipsis != NULL);
-        struct value* const res = idx_uz < sbuf_count(elements)
-            ? value_clone(elements[idx_uz])
-            : value_clone(ellipsis);
-        value_del(lhs);
-        value_del(idx);
         return res;
     }
 
+    struct value* const lhs = eval_rvalue(expr->data.access_index.lhs);
     if (lhs->type->kind == TYPE_SLICE) {
         // Slices are constructed from a (pointer, count) pair which makes them
         // more-or-less normal pointers with some extra fancy bookkeeping.
@@ -979,17 +1048,22 @@ eval_rvalue_access_member_variable(struct expr const* expr)
     assert(expr != NULL);
     assert(expr->kind == EXPR_ACCESS_MEMBER_VARIABLE);
 
-    struct value* const lhs =
-        eval_rvalue(expr->data.access_member_variable.lhs);
+    struct value const* const borrowed =
+        eval_borrow(expr->data.access_member_variable.lhs);
+    struct value* const lhs = borrowed == NULL
+        ? eval_rvalue(expr->data.access_member_variable.lhs)
+        : NULL;
 
     struct value const* const member = value_xget_member_value(
         expr->location,
-        lhs,
+        borrowed != NULL ? borrowed : lhs,
         expr->data.access_member_variable.member_variable->name);
 
     struct value* const res = value_clone(member);
 
-    value_del(lhs);
+    if (lhs != NULL) {
+        value_del(lhs);
+    }
     return res;
 }
 
@@ -1168,6 +1242,18 @@ eval_rvalue_binary(struct expr const* expr)
     assert(expr != NULL);
     assert(expr->kind == EXPR_BINARY);
 
+    // Logical operators short-circuit, so the right hand side is only
+    // evaluated if the left hand side does not determine the result.
+    if (expr->data.binary.op == BOP_OR || expr->data.binary.op == BOP_AND) {
+        struct value* const lhs = eval_rvalue(expr->data.binary.lhs);
+        assert(lhs->type->kind == TYPE_BOOL);
+        if (lhs->data.boolean == (expr->data.binary.op == BOP_OR)) {
+            return lhs;
+        }
+        value_del(lhs);
+        return eval_rvalue(expr->data.binary.rhs);
+    }
+
     struct value* const lhs = eval_rvalue(expr->data.binary.lhs);
     struct value* const rhs = eval_rvalue(expr->data.binary.rhs);
     struct value* res = NULL;
@@ -1181,17 +1267,9 @@ eval_rvalue_binary(struct expr const* expr)
     }
 
     switch (expr->data.binary.op) {
-    case BOP_OR: {
-        assert(lhs->type->kind == TYPE_BOOL);
-        assert(rhs->type->kind == TYPE_BOOL);
-        res = value_new_boolean(lhs->data.boolean || rhs->data.boolean);
-        break;
-    }
+    case BOP_OR: /* fallthrough */
     case BOP_AND: {
-        assert(lhs->type->kind == TYPE_BOOL);
-        assert(rhs->type->kind == TYPE_BOOL);
-        res = value_new_boolean(lhs->data.boolean && rhs->data.boolean);
-        break;
+        UNREACHABLE();
     }
     case BOP_SHL: {
         assert(type_is_integer(lhs->type));
@@ -1805,3 +1883,763 @@ eval_lvalue_unary(struct expr const* expr)
     UNREACHABLE();
     return NULL;
 }
+
+static struct value*
+eval_rvalue_call(struct expr const* expr)
+{
+    assert(expr != NULL);
+    assert(expr->kind == EXPR_CALL);
+
+    struct value* const res = eval_call(expr);
+    assert(res != NULL);
+    return res;
+}
+
+static struct value*
+eval_call(struct expr const* expr)
+{
+    assert(expr != NULL);
+    assert(expr->kind == EXPR_CALL);
+
+    struct value* const callee = eval_rvalue(expr->data.call.function);
+    assert(callee->type->kind == TYPE_FUNCTION);
+    struct function const* const function = callee->data.function;
+    value_del(callee);
+    if (function->is_extern) {
+        fatal(
+            expr->location,
+            "constant expression contains call to extern function");
+    }
+
+    sbuf(struct expr const* const) const arguments = expr->data.call.arguments;
+    assert(sbuf_count(arguments) == sbuf_count(function->symbol_parameters));
+    sbuf(struct eval_local) locals = NULL;
+    for (size_t i = 0; i < sbuf_count(arguments); ++i) {
+        struct eval_local const local = {
+            .symbol = function->symbol_parameters[i],
+            .value = eval_rvalue(arguments[i]),
+        };
+        sbuf_push(locals, local);
+    }
+
+    if (current_frame == NULL) {
+        current_steps_remaining = EVAL_STEP_BUDGET;
+    }
+    if (current_call_depth >= EVAL_CALL_DEPTH_MAX) {
+        fatal(
+            expr->location,
+            "compile-time evaluation exceeded the maximum call depth of %u",
+            EVAL_CALL_DEPTH_MAX);
+    }
+
+    if (!function->is_complete) {
+        // The function body is resolved outside of the current frame so that
+        // constant expressions within the body are evaluated as ordinary
+        // constant expressions rather than as part of this call.
+        struct eval_frame* const save_frame = current_frame;
+        unsigned const save_call_depth = current_call_depth;
+        unsigned long const save_steps_remaining = current_steps_remaining;
+        current_frame = NULL;
+        current_call_depth = 0;
+        resolve_complete_function(expr->location, function);
+        current_frame = save_frame;
+        current_call_depth = save_call_depth;
+        current_steps_remaining = save_steps_remaining;
+    }
+
+    struct eval_frame frame = {
+        .function = function,
+        .locals = locals,
+        .return_value = NULL,
+    };
+    struct eval_frame* const save_frame = current_frame;
+    current_frame = &frame;
+    current_call_depth += 1;
+    eval_block(&function->body);
+    current_call_depth -= 1;
+    current_frame = save_frame;
+
+    for (size_t i = 0; i < sbuf_count(frame.locals); ++i) {
+        if (frame.locals[i].value != NULL) {
+            value_del(frame.locals[i].value);
+        }
+    }
+    sbuf_fini(frame.locals);
+
+    return frame.return_value;
+}
+
+static void
+eval_step(struct source_location location)
+{
+    if (current_steps_remaining == 0) {
+        fatal(
+            location,
+            "compile-time evaluation exceeded the limit of %lu steps",
+            EVAL_STEP_BUDGET);
+    }
+    current_steps_remaining -= 1;
+}
+
+static enum eval_flow
+eval_block(struct block const* block)
+{
+    assert(block != NULL);
+    assert(current_frame != NULL);
+
+    // Reset the local variables declared in this block, matching the
+    // zero-initialization of locals at the start of each block in generated
+    // code. Without the reset, a local declared within a loop body would
+    // retain its value from the previous iteration.
+    sbuf(struct symbol_table_element) const elements =
+        block->symbol_table->elements;
+    sbuf(struct eval_local) const locals = current_frame->locals;
+    for (size_t i = 0; i < sbuf_count(elements); ++i) {
+        struct symbol const* const symbol = elements[i].symbol;
+        if (!eval_is_local(symbol)
+            || symbol_xget_address(symbol)->data.local.is_parameter) {
+            continue;
+        }
+
+        if (current_for_range_loop != NULL
+            && symbol == current_for_range_loop->data.for_range.loop_variable) {
+            // The loop variable is updated by the loop itself, and should
+            // *not* be reset at the start of the loop body.
+            continue;
+        }
+
+        for (size_t j = 0; j < sbuf_count(locals); ++j) {
+            if (locals[j].symbol == symbol && locals[j].value != NULL) {
+                value_del(locals[j].value);
+                locals[j].value =
+                    eval_new_uninit(block->location, symbol_xget_type(symbol));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sbuf_count(block->stmts); ++i) {
+        enum eval_flow const flow = eval_stmt(block->stmts[i]);
+        if (flow != EVAL_FLOW_NEXT) {
+            return flow;
+        }
+    }
+    eval_defers(block->defer_begin, block->defer_end);
+    return EVAL_FLOW_NEXT;
+}
+
+static void
+eval_defers(struct stmt const* begin, struct stmt const* end)
+{
+    assert(begin == NULL || begin->kind == STMT_DEFER);
+    assert(end == NULL || end->kind == STMT_DEFER);
+
+    struct stmt const* current = begin;
+    while (current != end) {
+        eval_block(&current->data.defer.body);
+        current = current->data.defer.prev;
+    }
+}
+
+static enum eval_flow
+eval_stmt(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(current_frame != NULL);
+
+    eval_step(stmt->location);
+    switch (stmt->kind) {
+    case STMT_DEFER: {
+        // Deferred blocks are evaluated when control leaves their scope.
+        return EVAL_FLOW_NEXT;
+    }
+    case STMT_IF: {
+        sbuf(struct conditional const) const conditionals =
+            stmt->data.if_.conditionals;
+        for (size_t i = 0; i < sbuf_count(conditionals); ++i) {
+            struct expr const* const condition = conditionals[i].condition;
+            if (condition == NULL || eval_condition(condition)) {
+                return eval_block(&conditionals[i].body);
+            }
+        }
+        return EVAL_FLOW_NEXT;
+    }
+    case STMT_FOR_RANGE: {
+        return eval_stmt_for_range(stmt);
+    }
+    case STMT_FOR_EXPR: {
+        return eval_stmt_for_expr(stmt);
+    }
+    case STMT_BREAK: {
+        eval_defers(
+            stmt->data.break_.defer_begin, stmt->data.break_.defer_end);
+        return EVAL_FLOW_BREAK;
+    }
+    case STMT_CONTINUE: {
+        eval_defers(
+            stmt->data.continue_.defer_begin, stmt->data.continue_.defer_end);
+        return EVAL_FLOW_CONTINUE;
+    }
+    case STMT_SWITCH: {
+        return eval_stmt_switch(stmt);
+    }
+    case STMT_RETURN: {
+        return eval_stmt_return(stmt);
+    }
+    case STMT_ASSERT: {
+        if (!eval_condition(stmt->data.assert_.expr)) {
+            fatal(
+                stmt->location,
+                "assertion failure during compile-time evaluation");
+        }
+        return EVAL_FLOW_NEXT;
+    }
+    case STMT_ASSIGN: {
+        return eval_stmt_assign(stmt);
+    }
+    case STMT_EXPR: {
+        struct value* const value = stmt->data.expr->kind == EXPR_CALL
+            ? eval_call(stmt->data.expr)
+            : eval_rvalue(stmt->data.expr);
+        if (value != NULL) {
+            value_del(value);
+        }
+        return EVAL_FLOW_NEXT;
+    }
+    }
+
+    UNREACHABLE();
+    return EVAL_FLOW_NEXT;
+}
+
+static enum eval_flow
+eval_stmt_for_range(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_FOR_RANGE);
+
+    struct value* const begin = eval_rvalue(stmt->data.for_range.begin);
+    struct value* const end = eval_rvalue(stmt->data.for_range.end);
+    assert(type_is_integer(begin->type));
+    assert(type_is_integer(end->type));
+
+    struct expr const variable = {
+        .location = stmt->location,
+        .type = symbol_xget_type(stmt->data.for_range.loop_variable),
+        .kind = EXPR_SYMBOL,
+        .data.symbol = stmt->data.for_range.loop_variable,
+    };
+
+    struct stmt const* const save_current_for_range_loop =
+        current_for_range_loop;
+    current_for_range_loop = stmt;
+
+    enum eval_flow flow = EVAL_FLOW_NEXT;
+    struct bigint* const index = bigint_new(begin->data.integer);
+    while (bigint_cmp(index, end->data.integer) < 0) {
+        eval_step(stmt->location);
+
+        struct value** const slot = eval_local_slot(&variable);
+        assert(slot != NULL);
+        if (*slot != NULL) {
+            value_del(*slot);
+        }
+        *slot = value_new_integer(variable.type, bigint_new(index));
+
+        flow = eval_block(&stmt->data.for_range.body);
+        if (flow == EVAL_FLOW_BREAK || flow == EVAL_FLOW_RETURN) {
+            break;
+        }
+        flow = EVAL_FLOW_NEXT;
+
+        struct bigint* const next = bigint_new(BIGINT_ZERO);
+        bigint_add(next, index, BIGINT_POS_ONE);
+        bigint_assign(index, next);
+        bigint_del(next);
+    }
+
+    current_for_range_loop = save_current_for_range_loop;
+
+    bigint_del(index);
+    value_del(begin);
+    value_del(end);
+    return flow == EVAL_FLOW_RETURN ? EVAL_FLOW_RETURN : EVAL_FLOW_NEXT;
+}
+
+static enum eval_flow
+eval_stmt_for_expr(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_FOR_EXPR);
+
+    while (eval_condition(stmt->data.for_expr.expr)) {
+        eval_step(stmt->location);
+
+        enum eval_flow const flow = eval_block(&stmt->data.for_expr.body);
+        if (flow == EVAL_FLOW_BREAK) {
+            break;
+        }
+        if (flow == EVAL_FLOW_RETURN) {
+            return EVAL_FLOW_RETURN;
+        }
+    }
+
+    return EVAL_FLOW_NEXT;
+}
+
+static enum eval_flow
+eval_stmt_switch(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_SWITCH);
+
+    struct value* const value = eval_rvalue(stmt->data.switch_.expr);
+    sbuf(struct switch_case const) const cases = stmt->data.switch_.cases;
+    for (size_t i = 0; i < sbuf_count(cases); ++i) {
+        struct symbol const* const symbol = cases[i].symbol;
+        bool const matches = symbol == NULL
+            || value_eq(value, symbol_xget_value(stmt->location, symbol));
+        if (matches) {
+            value_del(value);
+            return eval_block(&cases[i].body);
+        }
+    }
+
+    value_del(value);
+    return EVAL_FLOW_NEXT;
+}
+
+static enum eval_flow
+eval_stmt_return(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_RETURN);
+
+    if (stmt->data.return_.expr != NULL) {
+        struct value* const value = eval_rvalue(stmt->data.return_.expr);
+        if (current_frame->return_value != NULL) {
+            value_del(current_frame->return_value);
+        }
+        current_frame->return_value = value;
+    }
+
+    eval_defers(stmt->data.return_.defer, NULL);
+    return EVAL_FLOW_RETURN;
+}
+
+static enum eval_flow
+eval_stmt_assign(struct stmt const* stmt)
+{
+    assert(stmt != NULL);
+    assert(stmt->kind == STMT_ASSIGN);
+
+    static enum bop_kind const bops[] = {
+        [AOP_ADD_ASSIGN] = BOP_ADD,
+        [AOP_SUB_ASSIGN] = BOP_SUB,
+        [AOP_MUL_ASSIGN] = BOP_MUL,
+        [AOP_DIV_ASSIGN] = BOP_DIV,
+        [AOP_REM_ASSIGN] = BOP_REM,
+        [AOP_ADD_WRAPPING_ASSIGN] = BOP_ADD_WRAPPING,
+        [AOP_SUB_WRAPPING_ASSIGN] = BOP_SUB_WRAPPING,
+        [AOP_MUL_WRAPPING_ASSIGN] = BOP_MUL_WRAPPING,
+        [AOP_SHL_ASSIGN] = BOP_SHL,
+        [AOP_SHR_ASSIGN] = BOP_SHR,
+        [AOP_BITOR_ASSIGN] = BOP_BITOR,
+        [AOP_BITXOR_ASSIGN] = BOP_BITXOR,
+        [AOP_BITAND_ASSIGN] = BOP_BITAND,
+    };
+
+    // The right hand side is evaluated before the storage of the left hand
+    // side is looked up, since evaluating the right hand side may introduce
+    // new locals into the current frame.
+    struct expr const* const lhs = stmt->data.assign.lhs;
+    struct value* value = eval_rvalue(stmt->data.assign.rhs);
+    if (stmt->data.assign.op != AOP_ASSIGN) {
+        struct value* const current = eval_rvalue(lhs);
+        struct expr const binary_lhs = {
+            .location = lhs->location,
+            .type = current->type,
+            .kind = EXPR_VALUE,
+            .data.value = current,
+        };
+        struct expr const binary_rhs = {
+            .location = stmt->data.assign.rhs->location,
+            .type = value->type,
+            .kind = EXPR_VALUE,
+            .data.value = value,
+        };
+        struct expr const binary = {
+            .location = stmt->location,
+            .type = lhs->type,
+            .kind = EXPR_BINARY,
+            .data.binary = {
+                .op = bops[stmt->data.assign.op],
+                .lhs = &binary_lhs,
+                .rhs = &binary_rhs,
+            },
+        };
+        struct value* const result = eval_rvalue(&binary);
+        value_del(current);
+        value_del(value);
+        value = result;
+    }
+
+    struct value** const slot = eval_local_slot(lhs);
+    if (slot == NULL) {
+        fatal(
+            lhs->location,
+            "assignment to non-local object in compile-time expression");
+    }
+    if (*slot != NULL) {
+        value_del(*slot);
+    }
+    *slot = value;
+    return EVAL_FLOW_NEXT;
+}
+
+static bool
+eval_condition(struct expr const* expr)
+{
+    assert(expr != NULL);
+
+    struct value* const value = eval_rvalue(expr);
+    assert(value->type->kind == TYPE_BOOL);
+    bool const res = value->data.boolean;
+    value_del(value);
+    return res;
+}
+
+// Returns true if the provided symbol is a local variable of the function
+// currently being evaluated.
+static bool
+eval_is_local(struct symbol const* symbol)
+{
+    assert(symbol != NULL);
+
+    return current_frame != NULL && symbol->kind == SYMBOL_VARIABLE
+        && symbol_xget_address(symbol)->kind == ADDRESS_LOCAL;
+}
+
+// Returns a pointer to the storage of the local variable, array element, or
+// member variable designated by the provided expression, or NULL if the
+// expression does not designate (part of) a local variable of the function
+// currently being evaluated. Uninitialized locals are zero-initialized on
+// first use, matching the zero-initialization of locals in generated code.
+static struct value**
+eval_local_slot(struct expr const* expr)
+{
+    assert(expr != NULL);
+
+    switch (expr->kind) {
+    case EXPR_SYMBOL: {
+        struct symbol const* const symbol = expr->data.symbol;
+        if (!eval_is_local(symbol)) {
+            return NULL;
+        }
+
+        sbuf(struct eval_local) const locals = current_frame->locals;
+        for (size_t i = 0; i < sbuf_count(locals); ++i) {
+            if (locals[i].symbol == symbol) {
+                return &locals[i].value;
+            }
+        }
+
+        struct eval_local const local = {
+            .symbol = symbol,
+            .value = eval_new_uninit(expr->location, symbol_xget_type(symbol)),
+        };
+        sbuf_push(current_frame->locals, local);
+        return &current_frame->locals[sbuf_count(current_frame->locals) - 1]
+                    .value;
+    }
+    case EXPR_ACCESS_INDEX: {
+        struct type const* const array_type =
+            expr->data.access_index.lhs->type;
+        if (array_type->kind != TYPE_ARRAY) {
+            return NULL;
+        }
+
+        size_t const idx_uz =
+            eval_array_index(expr->data.access_index.idx, array_type);
+        struct value** const lhs = eval_local_slot(expr->data.access_index.lhs);
+        if (lhs == NULL) {
+            return NULL;
+        }
+        if (*lhs == NULL) {
+            *lhs = eval_new_uninit(expr->location, array_type);
+        }
+
+        // Expand elements initialized via an ellipsis element so that each
+        // element has its own storage.
+        struct value* const array = *lhs;
+        assert(array_type->data.array.count <= SIZE_MAX);
+        size_t const count = (size_t)array_type->data.array.count;
+        if (sbuf_count(array->data.array.elements) != count) {
+            assert(array->data.array.ellipsis != NULL);
+            while (sbuf_count(array->data.array.elements) != count) {
+                sbuf_push(
+                    array->data.array.elements,
+                    value_clone(array->data.array.ellipsis));
+            }
+            value_del(array->data.array.ellipsis);
+            array->data.array.ellipsis = NULL;
+        }
+        return &array->data.array.elements[idx_uz];
+    }
+    case EXPR_ACCESS_MEMBER_VARIABLE: {
+        struct expr const* const lhs_expr =
+            expr->data.access_member_variable.lhs;
+        struct value** const lhs = eval_local_slot(lhs_expr);
+        if (lhs == NULL) {
+            return NULL;
+        }
+        if (*lhs == NULL) {
+            *lhs = eval_new_uninit(expr->location, lhs_expr->type);
+        }
+
+        struct value* const object = *lhs;
+        struct member_variable const* const member_variable =
+            expr->data.access_member_variable.member_variable;
+        if (object->type->kind == TYPE_STRUCT) {
+            long const index = type_struct_member_variable_index(
+                object->type, member_variable->name);
+            assert(index >= 0);
+            return &object->data.struct_.member_values[index];
+        }
+
+        assert(object->type->kind == TYPE_UNION);
+        if (object->data.union_.member_variable != member_variable) {
+            if (object->data.union_.member_value != NULL) {
+                value_del(object->data.union_.member_value);
+            }
+            object->data.union_.member_variable = member_variable;
+            object->data.union_.member_value =
+                eval_new_uninit(expr->location, member_variable->type);
+        }
+        return &object->data.union_.member_value;
+    }
+    case EXPR_VALUE: /* fallthrough */
+    case EXPR_BYTES: /* fallthrough */
+    case EXPR_ARRAY_LIST: /* fallthrough */
+    case EXPR_SLICE_LIST: /* fallthrough */
+    case EXPR_SLICE: /* fallthrough */
+    case EXPR_INIT: /* fallthrough */
+    case EXPR_CAST: /* fallthrough */
+    case EXPR_CALL: /* fallthrough */
+    case EXPR_ACCESS_SLICE: /* fallthrough */
+    case EXPR_SIZEOF: /* fallthrough */
+    case EXPR_ALIGNOF: /* fallthrough */
+    case EXPR_UNARY: /* fallthrough */
+    case EXPR_BINARY: {
+        return NULL;
+    }
+    }
+
+    UNREACHABLE();
+    return NULL;
+}
+
+// Returns a non-owning reference to the value of the local variable, constant,
+// array element, or member variable designated by the provided expression, or
+// NULL if the expression must instead be evaluated as an rvalue.
+static struct value const*
+eval_borrow(struct expr const* expr)
+{
+    assert(expr != NULL);
+
+    switch (expr->kind) {
+    case EXPR_SYMBOL: {
+        struct symbol const* const symbol = expr->data.symbol;
+        if (symbol->kind == SYMBOL_CONSTANT) {
+            return symbol_xget_value(expr->location, symbol);
+        }
+        if (!eval_is_local(symbol)) {
+            return NULL;
+        }
+
+        struct value* const* const slot = eval_local_slot(expr);
+        if (*slot == NULL) {
+            fatal(
+                expr->location,
+                "use of uninitialized local `%s` in compile-time expression",
+                symbol->name);
+        }
+        return *slot;
+    }
+    case EXPR_ACCESS_INDEX: {
+        struct expr const* const lhs = expr->data.access_index.lhs;
+        if (lhs->type->kind != TYPE_ARRAY) {
+            return NULL;
+        }
+        // Only evaluate the index if the array itself may be borrowed, since
+        // the caller will otherwise evaluate this expression as an rvalue.
+        struct expr const* root = lhs;
+        while (root->kind == EXPR_ACCESS_INDEX
+               || root->kind == EXPR_ACCESS_MEMBER_VARIABLE) {
+            root = root->kind == EXPR_ACCESS_INDEX
+                ? root->data.access_index.lhs
+                : root->data.access_member_variable.lhs;
+        }
+        if (root->kind != EXPR_SYMBOL
+            || (root->data.symbol->kind != SYMBOL_CONSTANT
+                && !eval_is_local(root->data.symbol))) {
+            return NULL;
+        }
+
+        size_t const idx_uz =
+            eval_array_index(expr->data.access_index.idx, lhs->type);
+        struct value const* const array = eval_borrow(lhs);
+        if (array == NULL) {
+            return NULL;
+        }
+        sbuf(struct value* const) const elements = array->data.array.elements;
+        struct value const* const element = idx_uz < sbuf_count(elements)
+            ? elements[idx_uz]
+            : array->data.array.ellipsis;
+        if (element == NULL) {
+            fatal(
+                expr->location,
+                "use of uninitialized array element in compile-time expression");
+        }
+        return element;
+    }
+    case EXPR_ACCESS_MEMBER_VARIABLE: {
+        struct value const* const object =
+            eval_borrow(expr->data.access_member_variable.lhs);
+        if (object == NULL) {
+            return NULL;
+        }
+        return value_xget_member_value(
+            expr->location,
+            object,
+            expr->data.access_member_variable.member_variable->name);
+    }
+    case EXPR_VALUE: /* fallthrough */
+    case EXPR_BYTES: /* fallthrough */
+    case EXPR_ARRAY_LIST: /* fallthrough */
+    case EXPR_SLICE_LIST: /* fallthrough */
+    case EXPR_SLICE: /* fallthrough */
+    case EXPR_INIT: /* fallthrough */
+    case EXPR_CAST: /* fallthrough */
+    case EXPR_CALL: /* fallthrough */
+    case EXPR_ACCESS_SLICE: /* fallthrough */
+    case EXPR_SIZEOF: /* fallthrough */
+    case EXPR_ALIGNOF: /* fallthrough */
+    case EXPR_UNARY: /* fallthrough */
+    case EXPR_BINARY: {
+        return NULL;
+    }
+    }
+
+    UNREACHABLE();
+    return NULL;
+}
+
+// Evaluate the index of an array access, producing an error if the index is
+// out-of-bounds for the provided array type.
+static size_t
+eval_array_index(struct expr const* idx, struct type const* array_type)
+{
+    assert(idx != NULL);
+    assert(array_type != NULL);
+    assert(array_type->kind == TYPE_ARRAY);
+
+    struct value* const value = eval_rvalue(idx);
+    assert(value->type->kind == TYPE_USIZE);
+    size_t idx_uz = 0u;
+    if (bigint_to_uz(&idx_uz, value->data.integer)) {
+        fatal(
+            idx->location,
+            "index out-of-range (received %s)",
+            bigint_to_new_cstr(value->data.integer));
+    }
+    value_del(value);
+
+    if (idx_uz >= array_type->data.array.count) {
+        fatal(
+            idx->location,
+            "index out-of-bounds (array count is %ju, received %zu)",
+            array_type->data.array.count,
+            idx_uz);
+    }
+    return idx_uz;
+}
+
+// Create the zero value used as the initial value of an uninitialized local.
+// Struct member variables of the created value are initialized on first use.
+static struct value*
+eval_new_uninit(struct source_location location, struct type const* type)
+{
+    assert(type != NULL);
+
+    switch (type->kind) {
+    case TYPE_BOOL: {
+        return value_new_boolean(false);
+    }
+    case TYPE_BYTE: {
+        return value_new_byte(0x00);
+    }
+    case TYPE_U8: /* fallthrough */
+    case TYPE_S8: /* fallthrough */
+    case TYPE_U16: /* fallthrough */
+    case TYPE_S16: /* fallthrough */
+    case TYPE_U32: /* fallthrough */
+    case TYPE_S32: /* fallthrough */
+    case TYPE_U64: /* fallthrough */
+    case TYPE_S64: /* fallthrough */
+    case TYPE_USIZE: /* fallthrough */
+    case TYPE_SSIZE: /* fallthrough */
+    case TYPE_INTEGER: {
+        return value_new_integer(type, bigint_new(BIGINT_ZERO));
+    }
+    case TYPE_F32: {
+        return value_new_f32(0.0f);
+    }
+    case TYPE_F64: {
+        return value_new_f64(0.0);
+    }
+    case TYPE_REAL: {
+        return value_new_real(0.0);
+    }
+    case TYPE_POINTER: {
+        return value_new_pointer(type, address_init_absolute(0));
+    }
+    case TYPE_ARRAY: {
+        struct value* const ellipsis = type->data.array.count != 0
+            ? eval_new_uninit(location, type->data.array.base)
+            : NULL;
+        return value_new_array(type, NULL, ellipsis);
+    }
+    case TYPE_SLICE: {
+        struct value* const start = value_new_pointer(
+            type_unique_pointer(type->data.slice.base),
+            address_init_absolute(0));
+        struct value* const count = value_new_integer(
+            context()->builtin.usize, bigint_new(BIGINT_ZERO));
+        return value_new_slice(type, start, count);
+    }
+    case TYPE_STRUCT: {
+        return value_new_struct(type);
+    }
+    case TYPE_UNION: {
+        return value_new_union(type);
+    }
+    case TYPE_ENUM: {
+        struct value* const value = value_new_integer(
+            type->data.enum_.underlying_type, bigint_new(BIGINT_ZERO));
+        value->type = type;
+        return value;
+    }
+    case TYPE_ANY: /* fallthrough */
+    case TYPE_VOID: /* fallthrough */
+    case TYPE_FUNCTION: /* fallthrough */
+    case TYPE_EXTERN: {
+        break;
+    }
+    }
+
+    fatal(
+        location,
+        "uninitialized object of type `%s` not supported in compile-time expressions",
+        type->name);
+    return NULL;
+}
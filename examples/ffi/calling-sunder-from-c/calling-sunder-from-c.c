@@ -6,6 +6,14 @@ extern int const examplelib_y;
 extern void examplelib_puts(char const* start, size_t count);
 extern void examplelib_yell(char const* start, size_t count);
 
+struct examplelib_vec3 {
+    double x;
+    double y;
+    double z;
+};
+extern struct examplelib_vec3
+examplelib_scale(struct examplelib_vec3 v, double factor);
+
 int
 main(void)
 {
@@ -17,4 +25,8 @@ main(void)
 
     examplelib_x += 1;
     printf("x + y = %d\n", examplelib_x + examplelib_y);
+
+    struct examplelib_vec3 v = {1.0, 2.0, 3.0};
+    v = examplelib_scale(v, 2.0);
+    printf("scaled = (%g, %g, %g)\n", v.x, v.y, v.z);
 }
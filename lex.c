@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #include <assert.h>
 #include <errno.h>
+#include <limits.h> /* UCHAR_MAX */
 #include <stdlib.h>
 #include <string.h>
 
@@ -25,8 +26,6 @@ struct vstr {
     {str_literal, STR_LITERAL_COUNT(str_literal)}
 // clang-format on
 
-static enum token_kind const KEYWORDS_FIRST = TOKEN_TRUE;
-static enum token_kind const KEYWORDS_LAST = TOKEN_EMBED;
 static enum token_kind const SIGILS_FIRST = TOKEN_PLUS_PERCENT_ASSIGN;
 static enum token_kind const SIGILS_LAST = TOKEN_SEMICOLON;
 static struct vstr token_kind_vstrs[TOKEN_EOF + 1u] = {
@@ -81,6 +80,7 @@ static struct vstr token_kind_vstrs[TOKEN_EOF + 1u] = {
     [TOKEN_PERCENT_ASSIGN] = VSTR_INIT_STR_LITERAL("%="),
     [TOKEN_SHL_ASSIGN] = VSTR_INIT_STR_LITERAL("<<="),
     [TOKEN_SHR_ASSIGN] = VSTR_INIT_STR_LITERAL(">>="),
+    [TOKEN_HASH_LBRACKET] = VSTR_INIT_STR_LITERAL("#["),
     [TOKEN_SHL] = VSTR_INIT_STR_LITERAL("<<"),
     [TOKEN_SHR] = VSTR_INIT_STR_LITERAL(">>"),
     [TOKEN_PIPE_ASSIGN] = VSTR_INIT_STR_LITERAL("|="),
@@ -260,23 +260,288 @@ token_init_ieee754(
     return token;
 }
 
+// Character classes used by the lexer. Each byte value maps to the set of
+// classes containing that byte. Bytes outside of the ASCII printable and
+// whitespace ranges belong to no class.
+enum char_class {
+    CHAR_CLASS_SPACE = 1u << 0, // ' ', '\f', '\n', '\r', '\t', '\v'
+    CHAR_CLASS_PUNCT = 1u << 1, // Graphical characters other than [A-Za-z0-9]
+    CHAR_CLASS_ALPHA = 1u << 2, // [A-Za-z]
+    CHAR_CLASS_IDENT = 1u << 3, // [A-Za-z0-9_]
+    CHAR_CLASS_DIGIT = 1u << 4, // [0-9]
+    CHAR_CLASS_BDIGIT = 1u << 5, // [0-1]
+    CHAR_CLASS_ODIGIT = 1u << 6, // [0-7]
+    CHAR_CLASS_XDIGIT = 1u << 7, // [0-9A-Fa-f]
+};
+// clang-format off
+#define CHAR_CLASS_LETTER_ (CHAR_CLASS_ALPHA | CHAR_CLASS_IDENT)
+#define CHAR_CLASS_XLETTER_ (CHAR_CLASS_LETTER_ | CHAR_CLASS_XDIGIT)
+#define CHAR_CLASS_DIGIT_ \
+    (CHAR_CLASS_IDENT | CHAR_CLASS_DIGIT | CHAR_CLASS_XDIGIT)
+#define CHAR_CLASS_ODIGIT_ (CHAR_CLASS_DIGIT_ | CHAR_CLASS_ODIGIT)
+#define CHAR_CLASS_BDIGIT_ (CHAR_CLASS_ODIGIT_ | CHAR_CLASS_BDIGIT)
+static unsigned char const char_classes[UCHAR_MAX + 1] = {
+    [' '] = CHAR_CLASS_SPACE, ['\f'] = CHAR_CLASS_SPACE,
+    ['\n'] = CHAR_CLASS_SPACE, ['\r'] = CHAR_CLASS_SPACE,
+    ['\t'] = CHAR_CLASS_SPACE, ['\v'] = CHAR_CLASS_SPACE,
+    ['!'] = CHAR_CLASS_PUNCT, ['"'] = CHAR_CLASS_PUNCT,
+    ['#'] = CHAR_CLASS_PUNCT, ['$'] = CHAR_CLASS_PUNCT,
+    ['%'] = CHAR_CLASS_PUNCT, ['&'] = CHAR_CLASS_PUNCT,
+    ['\''] = CHAR_CLASS_PUNCT, ['('] = CHAR_CLASS_PUNCT,
+    [')'] = CHAR_CLASS_PUNCT, ['*'] = CHAR_CLASS_PUNCT,
+    ['+'] = CHAR_CLASS_PUNCT, [','] = CHAR_CLASS_PUNCT,
+    ['-'] = CHAR_CLASS_PUNCT, ['.'] = CHAR_CLASS_PUNCT,
+    ['/'] = CHAR_CLASS_PUNCT, ['0'] = CHAR_CLASS_BDIGIT_,
+    ['1'] = CHAR_CLASS_BDIGIT_, ['2'] = CHAR_CLASS_ODIGIT_,
+    ['3'] = CHAR_CLASS_ODIGIT_, ['4'] = CHAR_CLASS_ODIGIT_,
+    ['5'] = CHAR_CLASS_ODIGIT_, ['6'] = CHAR_CLASS_ODIGIT_,
+    ['7'] = CHAR_CLASS_ODIGIT_, ['8'] = CHAR_CLASS_DIGIT_,
+    ['9'] = CHAR_CLASS_DIGIT_, [':'] = CHAR_CLASS_PUNCT,
+    [';'] = CHAR_CLASS_PUNCT, ['<'] = CHAR_CLASS_PUNCT,
+    ['='] = CHAR_CLASS_PUNCT, ['>'] = CHAR_CLASS_PUNCT,
+    ['?'] = CHAR_CLASS_PUNCT, ['@'] = CHAR_CLASS_PUNCT,
+    ['A'] = CHAR_CLASS_XLETTER_, ['B'] = CHAR_CLASS_XLETTER_,
+    ['C'] = CHAR_CLASS_XLETTER_, ['D'] = CHAR_CLASS_XLETTER_,
+    ['E'] = CHAR_CLASS_XLETTER_, ['F'] = CHAR_CLASS_XLETTER_,
+    ['G'] = CHAR_CLASS_LETTER_, ['H'] = CHAR_CLASS_LETTER_,
+    ['I'] = CHAR_CLASS_LETTER_, ['J'] = CHAR_CLASS_LETTER_,
+    ['K'] = CHAR_CLASS_LETTER_, ['L'] = CHAR_CLASS_LETTER_,
+    ['M'] = CHAR_CLASS_LETTER_, ['N'] = CHAR_CLASS_LETTER_,
+    ['O'] = CHAR_CLASS_LETTER_, ['P'] = CHAR_CLASS_LETTER_,
+    ['Q'] = CHAR_CLASS_LETTER_, ['R'] = CHAR_CLASS_LETTER_,
+    ['S'] = CHAR_CLASS_LETTER_, ['T'] = CHAR_CLASS_LETTER_,
+    ['U'] = CHAR_CLASS_LETTER_, ['V'] = CHAR_CLASS_LETTER_,
+    ['W'] = CHAR_CLASS_LETTER_, ['X'] = CHAR_CLASS_LETTER_,
+    ['Y'] = CHAR_CLASS_LETTER_, ['Z'] = CHAR_CLASS_LETTER_,
+    ['['] = CHAR_CLASS_PUNCT, ['\\'] = CHAR_CLASS_PUNCT,
+    [']'] = CHAR_CLASS_PUNCT, ['^'] = CHAR_CLASS_PUNCT,
+    ['_'] = CHAR_CLASS_PUNCT | CHAR_CLASS_IDENT, ['`'] = CHAR_CLASS_PUNCT,
+    ['a'] = CHAR_CLASS_XLETTER_, ['b'] = CHAR_CLASS_XLETTER_,
+    ['c'] = CHAR_CLASS_XLETTER_, ['d'] = CHAR_CLASS_XLETTER_,
+    ['e'] = CHAR_CLASS_XLETTER_, ['f'] = CHAR_CLASS_XLETTER_,
+    ['g'] = CHAR_CLASS_LETTER_, ['h'] = CHAR_CLASS_LETTER_,
+    ['i'] = CHAR_CLASS_LETTER_, ['j'] = CHAR_CLASS_LETTER_,
+    ['k'] = CHAR_CLASS_LETTER_, ['l'] = CHAR_CLASS_LETTER_,
+    ['m'] = CHAR_CLASS_LETTER_, ['n'] = CHAR_CLASS_LETTER_,
+    ['o'] = CHAR_CLASS_LETTER_, ['p'] = CHAR_CLASS_LETTER_,
+    ['q'] = CHAR_CLASS_LETTER_, ['r'] = CHAR_CLASS_LETTER_,
+    ['s'] = CHAR_CLASS_LETTER_, ['t'] = CHAR_CLASS_LETTER_,
+    ['u'] = CHAR_CLASS_LETTER_, ['v'] = CHAR_CLASS_LETTER_,
+    ['w'] = CHAR_CLASS_LETTER_, ['x'] = CHAR_CLASS_LETTER_,
+    ['y'] = CHAR_CLASS_LETTER_, ['z'] = CHAR_CLASS_LETTER_,
+    ['{'] = CHAR_CLASS_PUNCT, ['|'] = CHAR_CLASS_PUNCT,
+    ['}'] = CHAR_CLASS_PUNCT, ['~'] = CHAR_CLASS_PUNCT,
+};
+#undef CHAR_CLASS_LETTER_
+#undef CHAR_CLASS_XLETTER_
+#undef CHAR_CLASS_DIGIT_
+#undef CHAR_CLASS_ODIGIT_
+#undef CHAR_CLASS_BDIGIT_
+// clang-format on
+
+static inline bool
+char_is(char ch, unsigned classes)
+{
+    return (char_classes[(unsigned char)ch] & classes) != 0;
+}
+
+// Perfect hash of the keywords, computed from the first two and last
+// characters of the keyword. Every keyword has at least two characters.
+// Overlapping entries produced by a collision in this table are diagnosed by
+// -Woverride-init.
+#define KEYWORD_TABLE_COUNT 128u
+#define KEYWORD_HASH(c0, c1, cn)                                               \
+    ((4u * (unsigned)(c0) + 21u * (unsigned)(c1) + (unsigned)(cn))             \
+     % KEYWORD_TABLE_COUNT)
+// Slots not associated with any keyword are zero-initialized to the first
+// keyword. Matches are always verified against the keyword text, and a word
+// that is equal to the first keyword hashes to the first keyword's slot, so
+// these slots never produce a false match.
+static enum token_kind const keyword_table[KEYWORD_TABLE_COUNT] = {
+    [KEYWORD_HASH('t', 'r', 'e')] = TOKEN_TRUE,
+    [KEYWORD_HASH('f', 'a', 'e')] = TOKEN_FALSE,
+    [KEYWORD_HASH('n', 'o', 't')] = TOKEN_NOT,
+    [KEYWORD_HASH('o', 'r', 'r')] = TOKEN_OR,
+    [KEYWORD_HASH('a', 'n', 'd')] = TOKEN_AND,
+    [KEYWORD_HASH('n', 'a', 'e')] = TOKEN_NAMESPACE,
+    [KEYWORD_HASH('i', 'm', 't')] = TOKEN_IMPORT,
+    [KEYWORD_HASH('v', 'a', 'r')] = TOKEN_VAR,
+    [KEYWORD_HASH('l', 'e', 't')] = TOKEN_LET,
+    [KEYWORD_HASH('f', 'u', 'c')] = TOKEN_FUNC,
+    [KEYWORD_HASH('s', 't', 't')] = TOKEN_STRUCT,
+    [KEYWORD_HASH('u', 'n', 'n')] = TOKEN_UNION,
+    [KEYWORD_HASH('e', 'n', 'm')] = TOKEN_ENUM,
+    [KEYWORD_HASH('t', 'y', 'e')] = TOKEN_TYPE,
+    [KEYWORD_HASH('e', 'x', 'd')] = TOKEN_EXTEND,
+    [KEYWORD_HASH('e', 'x', 'n')] = TOKEN_EXTERN,
+    [KEYWORD_HASH('s', 'w', 'h')] = TOKEN_SWITCH,
+    [KEYWORD_HASH('r', 'e', 'n')] = TOKEN_RETURN,
+    [KEYWORD_HASH('a', 's', 't')] = TOKEN_ASSERT,
+    [KEYWORD_HASH('d', 'e', 'r')] = TOKEN_DEFER,
+    [KEYWORD_HASH('i', 'f', 'f')] = TOKEN_IF,
+    [KEYWORD_HASH('e', 'l', 'f')] = TOKEN_ELIF,
+    [KEYWORD_HASH('e', 'l', 'e')] = TOKEN_ELSE,
+    [KEYWORD_HASH('w', 'h', 'n')] = TOKEN_WHEN,
+    [KEYWORD_HASH('e', 'l', 'n')] = TOKEN_ELWHEN,
+    [KEYWORD_HASH('f', 'o', 'r')] = TOKEN_FOR,
+    [KEYWORD_HASH('i', 'n', 'n')] = TOKEN_IN,
+    [KEYWORD_HASH('b', 'r', 'k')] = TOKEN_BREAK,
+    [KEYWORD_HASH('c', 'o', 'e')] = TOKEN_CONTINUE,
+    [KEYWORD_HASH('d', 'e', 'd')] = TOKEN_DEFINED,
+    [KEYWORD_HASH('a', 'l', 'f')] = TOKEN_ALIGNOF,
+    [KEYWORD_HASH('s', 't', 'f')] = TOKEN_STARTOF,
+    [KEYWORD_HASH('c', 'o', 'f')] = TOKEN_COUNTOF,
+    [KEYWORD_HASH('s', 'i', 'f')] = TOKEN_SIZEOF,
+    [KEYWORD_HASH('t', 'y', 'f')] = TOKEN_TYPEOF,
+    [KEYWORD_HASH('f', 'i', 'f')] = TOKEN_FILEOF,
+    [KEYWORD_HASH('l', 'i', 'f')] = TOKEN_LINEOF,
+    [KEYWORD_HASH('u', 'n', 't')] = TOKEN_UNINIT,
+    [KEYWORD_HASH('e', 'm', 'd')] = TOKEN_EMBED,
+};
+
+// Sigils indexed by their first byte. Sigils within each list are ordered
+// such that a sigil appears before any shorter sigil that is a prefix of it.
+// Each list is terminated by the first (zero-initialized) non-sigil entry.
+#define SIGIL_CANDIDATES_MAX 4u
+static enum token_kind const sigils_by_first_byte[UCHAR_MAX + 1]
+                                                [SIGIL_CANDIDATES_MAX] = {
+    ['+'] =
+        {TOKEN_PLUS_PERCENT_ASSIGN, TOKEN_PLUS_ASSIGN,
+         TOKEN_PLUS_PERCENT, TOKEN_PLUS},
+    ['-'] =
+        {TOKEN_DASH_PERCENT_ASSIGN, TOKEN_DASH_ASSIGN,
+         TOKEN_DASH_PERCENT, TOKEN_DASH},
+    ['*'] =
+        {TOKEN_STAR_PERCENT_ASSIGN, TOKEN_STAR_ASSIGN,
+         TOKEN_STAR_PERCENT, TOKEN_STAR},
+    ['/'] = {TOKEN_FSLASH_ASSIGN, TOKEN_FSLASH},
+    ['%'] = {TOKEN_PERCENT_ASSIGN, TOKEN_PERCENT},
+    ['<'] = {TOKEN_SHL_ASSIGN, TOKEN_SHL, TOKEN_LE, TOKEN_LT},
+    ['>'] = {TOKEN_SHR_ASSIGN, TOKEN_SHR, TOKEN_GE, TOKEN_GT},
+    ['#'] = {TOKEN_HASH_LBRACKET},
+    ['|'] = {TOKEN_PIPE_ASSIGN, TOKEN_PIPE},
+    ['^'] = {TOKEN_CARET_ASSIGN, TOKEN_CARET},
+    ['&'] = {TOKEN_AMPERSAND_ASSIGN, TOKEN_AMPERSAND},
+    ['='] = {TOKEN_EQ, TOKEN_ASSIGN},
+    ['!'] = {TOKEN_NE},
+    ['~'] = {TOKEN_TILDE},
+    ['('] = {TOKEN_LPAREN},
+    [')'] = {TOKEN_RPAREN},
+    ['{'] = {TOKEN_LBRACE},
+    ['}'] = {TOKEN_RBRACE},
+    ['['] = {TOKEN_LBRACKET},
+    [']'] = {TOKEN_RBRACKET},
+    [','] = {TOKEN_COMMA},
+    ['.'] = {TOKEN_ELLIPSIS, TOKEN_DOT_STAR, TOKEN_DOT},
+    [':'] = {TOKEN_COLON_COLON, TOKEN_COLON},
+    [';'] = {TOKEN_SEMICOLON},
+};
+
 static void
 skip_whitespace(struct lexer* self)
 {
     assert(self != NULL);
 
-    while (safe_isspace(*self->current)) {
+    while (char_is(*self->current, CHAR_CLASS_SPACE)) {
         self->current_line += *self->current == '\n';
         self->current += 1;
     }
 }
 
+// Returns a pointer to the first character after any whitespace and comments
+// starting at `cur`.
+static char const*
+skip_whitespace_and_comments_lookahead(char const* cur)
+{
+    assert(cur != NULL);
+
+    while (char_is(*cur, CHAR_CLASS_SPACE) || *cur == '#') {
+        if (*cur != '#') {
+            cur += 1;
+            continue;
+        }
+        while (*cur != '\0' && *cur != '\n') {
+            cur += 1;
+        }
+    }
+    return cur;
+}
+
+// Returns true if the character sequence starting at `cur` with length
+// `count` is the name of a function attribute handled by the parser.
+static bool
+is_attribute_name(char const* cur, size_t count)
+{
+    assert(cur != NULL);
+
+    static char const* const names[] = {"inline", "noinline", "hot", "cold"};
+    for (size_t i = 0; i < ARRAY_COUNT(names); ++i) {
+        if (strlen(names[i]) == count && strncmp(cur, names[i], count) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if the character sequence starting at `cur` begins a function
+// attribute list, i.e. `#[` followed by a comma-separated list of attribute
+// names and `]`, with only whitespace and comments between the attribute list
+// and the `func` keyword. Any other sequence starting with `#[`, such as a
+// `#[deprecated]` comment preceding a function, is a comment.
+static bool
+is_attribute_list_start(char const* cur)
+{
+    assert(cur != NULL);
+
+    if (cur[0] != '#' || cur[1] != '[') {
+        return false;
+    }
+    cur += STR_LITERAL_COUNT("#[");
+
+    while (true) {
+        while (*cur == ' ' || *cur == '\t') {
+            cur += 1;
+        }
+        char const* const name = cur;
+        while (char_is(*cur, CHAR_CLASS_IDENT)) {
+            cur += 1;
+        }
+        if (!is_attribute_name(name, (size_t)(cur - name))) {
+            return false;
+        }
+        while (*cur == ' ' || *cur == '\t') {
+            cur += 1;
+        }
+        if (*cur == ']') {
+            break;
+        }
+        if (*cur != ',') {
+            return false;
+        }
+        cur += 1;
+    }
+    cur += STR_LITERAL_COUNT("]");
+
+    cur = skip_whitespace_and_comments_lookahead(cur);
+    return strncmp(cur, "func", STR_LITERAL_COUNT("func")) == 0
+        && !char_is(cur[STR_LITERAL_COUNT("func")], CHAR_CLASS_IDENT);
+}
+
+// Returns true if the character sequence starting at `cur` begins a comment.
+static bool
+is_comment_start(char const* cur)
+{
+    assert(cur != NULL);
+
+    return cur[0] == '#' && !is_attribute_list_start(cur);
+}
+
 static void
 skip_comment(struct lexer* self)
 {
     assert(self != NULL);
 
-    if (*self->current != '#') {
+    if (!is_comment_start(self->current)) {
         return;
     }
 
@@ -294,7 +559,8 @@ skip_whitespace_and_comments(struct lexer* self)
 {
     assert(self != NULL);
 
-    while (safe_isspace(*self->current) || (*self->current == '#')) {
+    while (char_is(*self->current, CHAR_CLASS_SPACE)
+           || is_comment_start(self->current)) {
         skip_whitespace(self);
         skip_comment(self);
     }
@@ -304,20 +570,24 @@ static struct token
 lex_keyword_or_identifier(struct lexer* self, struct source_location location)
 {
     assert(self != NULL);
-    assert(safe_isalpha(*self->current) || *self->current == '_');
+    assert(char_is(*self->current, CHAR_CLASS_ALPHA) || *self->current == '_');
 
     char const* const start = self->current;
-    while (safe_isalnum(*self->current) || *self->current == '_') {
+    while (char_is(*self->current, CHAR_CLASS_IDENT)) {
         self->current += 1;
     }
     size_t const count = (size_t)(self->current - start);
+    if (count < 2) {
+        return token_init_identifier(start, count, location);
+    }
 
-    for (int i = (int)KEYWORDS_FIRST; i <= (int)KEYWORDS_LAST; ++i) {
-        struct vstr const* const keyword = &token_kind_vstrs[i];
-        if (count == keyword->count
-            && safe_memcmp(start, keyword->start, count) == 0) {
-            return token_init(start, count, location, (enum token_kind)i);
-        }
+    enum token_kind const kind =
+        keyword_table[KEYWORD_HASH(start[0], start[1], start[count - 1])];
+    struct vstr const* const keyword = &token_kind_vstrs[kind];
+    assert(TOKEN_TRUE <= kind && kind <= TOKEN_EMBED); // Keyword token kinds.
+    if (count == keyword->count
+        && safe_memcmp(start, keyword->start, count) == 0) {
+        return token_init(start, count, location, kind);
     }
 
     return token_init_identifier(start, count, location);
@@ -327,43 +597,43 @@ static struct token
 lex_number(struct lexer* self, struct source_location location)
 {
     assert(self != NULL);
-    assert(safe_isdigit(*self->current));
+    assert(char_is(*self->current, CHAR_CLASS_DIGIT));
 
     // Prefix
     char const* const number_start = self->current;
-    int (*radix_isdigit)(int c) = safe_isdigit;
+    unsigned radix_class = CHAR_CLASS_DIGIT;
     if (cstr_starts_with(self->current, "0b")) {
         self->current += STR_LITERAL_COUNT("0b");
-        radix_isdigit = safe_isbdigit;
+        radix_class = CHAR_CLASS_BDIGIT;
     }
     else if (cstr_starts_with(self->current, "0o")) {
         self->current += STR_LITERAL_COUNT("0o");
-        radix_isdigit = safe_isodigit;
+        radix_class = CHAR_CLASS_ODIGIT;
     }
     else if (cstr_starts_with(self->current, "0x")) {
         self->current += STR_LITERAL_COUNT("0x");
-        radix_isdigit = safe_isxdigit;
+        radix_class = CHAR_CLASS_XDIGIT;
     }
 
     // Digits
-    if (!radix_isdigit(*self->current)) {
+    if (!char_is(*self->current, radix_class)) {
         struct source_location const location = {
             self->module->name, self->current_line, self->current};
         fatal(location, "integer literal has no digits");
     }
-    while (radix_isdigit(*self->current)) {
+    while (char_is(*self->current, radix_class)) {
         self->current += 1;
     }
 
     // Digits (fractional component)
-    bool is_ieee754 =
-        self->current[0] == '.' && !safe_ispunct(self->current[1]);
+    bool is_ieee754 = self->current[0] == '.'
+        && !char_is(self->current[1], CHAR_CLASS_PUNCT);
     if (is_ieee754) {
-        if (radix_isdigit != safe_isdigit) {
+        if (radix_class != CHAR_CLASS_DIGIT) {
             fatal(location, "floating point literal has non-decimal base");
         }
         self->current += 1; // Skip the '.' character.
-        while (radix_isdigit(*self->current)) {
+        while (char_is(*self->current, radix_class)) {
             self->current += 1;
         }
     }
@@ -377,7 +647,7 @@ lex_number(struct lexer* self, struct source_location location)
 
     // Suffix
     char const* const suffix_start = self->current;
-    while (safe_isalnum(*self->current)) {
+    while (char_is(*self->current, CHAR_CLASS_ALPHA | CHAR_CLASS_DIGIT)) {
         self->current += 1;
     }
     size_t const suffix_count = (size_t)(self->current - suffix_start);
@@ -453,8 +723,8 @@ advance_character(struct lexer* self, char const* what)
         return '\\';
     }
     case 'x': {
-        if (!safe_isxdigit(self->current[2])
-            || !safe_isxdigit(self->current[3])) {
+        if (!char_is(self->current[2], CHAR_CLASS_XDIGIT)
+            || !char_is(self->current[3], CHAR_CLASS_XDIGIT)) {
             struct source_location const location = {
                 self->module->name, self->current_line, self->current};
             fatal(location, "invalid hexadecimal escape sequence");
@@ -552,21 +822,26 @@ static struct token
 lex_sigil(struct lexer* self, struct source_location location)
 {
     assert(self != NULL);
-    assert(safe_ispunct(*self->current));
-
-    for (int i = (int)SIGILS_FIRST; i <= (int)SIGILS_LAST; ++i) {
-        char const* const sigil_start = token_kind_vstrs[i].start;
-        size_t const sigil_count = token_kind_vstrs[i].count;
+    assert(char_is(*self->current, CHAR_CLASS_PUNCT));
+
+    enum token_kind const* const candidates =
+        sigils_by_first_byte[(unsigned char)*self->current];
+    for (size_t i = 0; i < SIGIL_CANDIDATES_MAX; ++i) {
+        enum token_kind const kind = candidates[i];
+        if (kind < SIGILS_FIRST || kind > SIGILS_LAST) {
+            break;
+        }
+        char const* const sigil_start = token_kind_vstrs[kind].start;
+        size_t const sigil_count = token_kind_vstrs[kind].count;
         if (cstr_starts_with(self->current, sigil_start)) {
             self->current += sigil_count;
-            return token_init(
-                sigil_start, sigil_count, location, (enum token_kind)i);
+            return token_init(sigil_start, sigil_count, location, kind);
         }
     }
 
     char const* const start = self->current;
     size_t count = 0;
-    while (safe_ispunct(start[count]) && start[count] != '#') {
+    while (char_is(start[count], CHAR_CLASS_PUNCT) && start[count] != '#') {
         count += 1;
     }
 
@@ -587,10 +862,10 @@ lexer_next_token(struct lexer* self)
     };
 
     char const ch = *self->current;
-    if (safe_isalpha(ch) || ch == '_') {
+    if (char_is(ch, CHAR_CLASS_ALPHA) || ch == '_') {
         return lex_keyword_or_identifier(self, location);
     }
-    if (safe_isdigit(ch)) {
+    if (char_is(ch, CHAR_CLASS_DIGIT)) {
         return lex_number(self, location);
     }
     if (ch == '\'' && *(self->current + 1) != '\'') {
@@ -599,7 +874,7 @@ lexer_next_token(struct lexer* self)
     if (ch == '\"') {
         return lex_bytes(self, location);
     }
-    if (safe_ispunct(ch)) {
+    if (char_is(ch, CHAR_CLASS_PUNCT)) {
         return lex_sigil(self, location);
     }
     if (ch == '\0') {
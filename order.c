@@ -30,6 +30,15 @@ struct orderer {
     sbuf(struct cst_decl const*) topological_order;
     // List of declaration dependencies.
     sbuf(struct cst_decl const*) dependencies;
+    // Module-level functions that are called from an expression that may be
+    // evaluated at compile-time, and whose bodies have already been searched
+    // for dependencies.
+    sbuf(struct cst_decl const*) called_functions;
+    // True if the orderer is searching the body of a called function. Function
+    // bodies may refer back to the declaration that called them (e.g. a
+    // function that reads a constant initialized by a call to that function),
+    // so circular dependencies are not reported in this state.
+    bool is_within_called_function;
 };
 static struct orderer*
 orderer_new(struct module* module);
@@ -43,6 +52,12 @@ order_tldecl(struct orderer* orderer, struct tldecl* tldecl);
 static void
 order_decl(struct orderer* orderer, struct cst_decl const* decl);
 static void
+order_called_function(struct orderer* orderer, struct cst_expr const* func);
+static void
+order_block(struct orderer* orderer, struct cst_block const* block);
+static void
+order_stmt(struct orderer* orderer, struct cst_stmt const* stmt);
+static void
 order_expr(struct orderer* orderer, struct cst_expr const* expr);
 static void
 order_template_argument_list(
@@ -113,6 +128,7 @@ orderer_del(struct orderer* self)
     sbuf_fini(self->tldecls);
     sbuf_fini(self->topological_order);
     sbuf_fini(self->dependencies);
+    sbuf_fini(self->called_functions);
 
     memset(self, 0x00, sizeof(*self));
     xalloc(self, XALLOC_FREE);
@@ -144,6 +160,14 @@ order_tldecl(struct orderer* orderer, struct tldecl* tldecl)
         // Top-level declaration is already ordered.
         return;
     }
+    bool const is_ordering = tldecl->state == TLDECL_ORDERING;
+    if (is_ordering && orderer->is_within_called_function) {
+        // Top-level declaration is currently in the process of being ordered,
+        // and is referenced from within the body of a called function. Any
+        // actual use of the declaration during compile-time evaluation will be
+        // reported as an error during the resolve phase.
+        return;
+    }
     if (tldecl->state == TLDECL_ORDERING) {
         // Top-level declaration is currently in the process of being ordered.
         error(
@@ -167,9 +191,13 @@ order_tldecl(struct orderer* orderer, struct tldecl* tldecl)
     // will be detected if another attempt is made to order this declaration.
     tldecl->state = TLDECL_ORDERING;
     // Perform ordering on the top level declaration.
+    bool const save_is_within_called_function =
+        orderer->is_within_called_function;
+    orderer->is_within_called_function = false;
     sbuf_push(orderer->dependencies, tldecl->decl);
     order_decl(orderer, tldecl->decl);
     sbuf_resize(orderer->dependencies, sbuf_count(orderer->dependencies) - 1);
+    orderer->is_within_called_function = save_is_within_called_function;
     // Change the state from ORDERING TO ORDERED after ordering the top level
     // declaration as well as all of top level declaration's dependencies.
     tldecl->state = TLDECL_ORDERED;
@@ -378,6 +406,146 @@ order_decl(struct orderer* orderer, struct cst_decl const* decl)
     UNREACHABLE();
 }
 
+// Functions called from an expression that may be evaluated at compile-time
+// have their bodies resolved before that expression is evaluated, so the
+// declarations referenced within the body of a called module-level function
+// are ordered before the calling declaration.
+static void
+order_called_function(struct orderer* orderer, struct cst_expr const* func)
+{
+    assert(orderer != NULL);
+    assert(func != NULL);
+
+    if (func->kind != CST_EXPR_SYMBOL) {
+        return;
+    }
+    struct cst_symbol const* const symbol = func->data.symbol;
+    if (symbol->start != CST_SYMBOL_START_NONE
+        || sbuf_count(symbol->elements) != 1
+        || sbuf_count(symbol->elements[0]->template_arguments) != 0) {
+        return;
+    }
+
+    struct tldecl const* const tldecl =
+        orderer_tldecl_lookup(orderer, symbol->elements[0]->identifier.name);
+    if (tldecl == NULL || tldecl->decl->kind != CST_DECL_FUNCTION
+        || sbuf_count(tldecl->decl->data.function.template_parameters) != 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < sbuf_count(orderer->called_functions); ++i) {
+        if (orderer->called_functions[i] == tldecl->decl) {
+            return;
+        }
+    }
+    sbuf_push(orderer->called_functions, tldecl->decl);
+
+    bool const save_is_within_called_function =
+        orderer->is_within_called_function;
+    orderer->is_within_called_function = true;
+    order_block(orderer, &tldecl->decl->data.function.body);
+    orderer->is_within_called_function = save_is_within_called_function;
+}
+
+static void
+order_block(struct orderer* orderer, struct cst_block const* block)
+{
+    assert(orderer != NULL);
+    assert(block != NULL);
+
+    for (size_t i = 0; i < sbuf_count(block->stmts); ++i) {
+        order_stmt(orderer, block->stmts[i]);
+    }
+}
+
+static void
+order_stmt(struct orderer* orderer, struct cst_stmt const* stmt)
+{
+    assert(orderer != NULL);
+    assert(stmt != NULL);
+
+    switch (stmt->kind) {
+    case CST_STMT_DECL: {
+        order_decl(orderer, stmt->data.decl);
+        return;
+    }
+    case CST_STMT_DEFER_BLOCK: {
+        order_block(orderer, &stmt->data.defer_block);
+        return;
+    }
+    case CST_STMT_DEFER_EXPR: {
+        order_expr(orderer, stmt->data.defer_expr);
+        return;
+    }
+    case CST_STMT_IF: /* fallthrough */
+    case CST_STMT_WHEN: {
+        sbuf(struct cst_conditional const) const conditionals =
+            stmt->kind == CST_STMT_IF ? stmt->data.if_.conditionals
+                                      : stmt->data.when.conditionals;
+        for (size_t i = 0; i < sbuf_count(conditionals); ++i) {
+            if (conditionals[i].condition != NULL) {
+                order_expr(orderer, conditionals[i].condition);
+            }
+            order_block(orderer, &conditionals[i].body);
+        }
+        return;
+    }
+    case CST_STMT_FOR_RANGE: {
+        if (stmt->data.for_range.type != NULL) {
+            order_type(orderer, stmt->data.for_range.type);
+        }
+        if (stmt->data.for_range.begin != NULL) {
+            order_expr(orderer, stmt->data.for_range.begin);
+        }
+        order_expr(orderer, stmt->data.for_range.end);
+        order_block(orderer, &stmt->data.for_range.body);
+        return;
+    }
+    case CST_STMT_FOR_EXPR: {
+        order_expr(orderer, stmt->data.for_expr.expr);
+        order_block(orderer, &stmt->data.for_expr.body);
+        return;
+    }
+    case CST_STMT_BREAK: /* fallthrough */
+    case CST_STMT_CONTINUE: {
+        return;
+    }
+    case CST_STMT_SWITCH: {
+        order_expr(orderer, stmt->data.switch_.expr);
+        sbuf(struct cst_switch_case const) const cases =
+            stmt->data.switch_.cases;
+        for (size_t i = 0; i < sbuf_count(cases); ++i) {
+            for (size_t j = 0; j < sbuf_count(cases[i].symbols); ++j) {
+                order_symbol(orderer, cases[i].symbols[j]);
+            }
+            order_block(orderer, &cases[i].block);
+        }
+        return;
+    }
+    case CST_STMT_RETURN: {
+        if (stmt->data.return_.expr != NULL) {
+            order_expr(orderer, stmt->data.return_.expr);
+        }
+        return;
+    }
+    case CST_STMT_ASSERT: {
+        order_expr(orderer, stmt->data.assert_.expr);
+        return;
+    }
+    case CST_STMT_ASSIGN: {
+        order_expr(orderer, stmt->data.assign.lhs);
+        order_expr(orderer, stmt->data.assign.rhs);
+        return;
+    }
+    case CST_STMT_EXPR: {
+        order_expr(orderer, stmt->data.expr);
+        return;
+    }
+    }
+
+    UNREACHABLE();
+}
+
 static void
 order_expr(struct orderer* orderer, struct cst_expr const* expr)
 {
@@ -439,6 +607,7 @@ order_expr(struct orderer* orderer, struct cst_expr const* expr)
         for (size_t i = 0; i < sbuf_count(arguments); ++i) {
             order_expr(orderer, arguments[i]);
         }
+        order_called_function(orderer, expr->data.call.func);
         return;
     }
     case CST_EXPR_ACCESS_INDEX: {
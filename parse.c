@@ -51,6 +51,10 @@ static struct cst_decl const*
 parse_decl_constant(struct parser* parser);
 static struct cst_decl const*
 parse_decl_function(struct parser* parser);
+static unsigned
+parse_function_attribute_list(struct parser* parser);
+static unsigned
+parse_function_attribute(struct parser* parser, unsigned attributes);
 static struct cst_decl const*
 parse_decl_struct(struct parser* parser);
 static struct cst_decl const*
@@ -435,7 +439,8 @@ parse_decl(struct parser* parser)
         return parse_decl_constant(parser);
     }
 
-    if (check_current(parser, TOKEN_FUNC)) {
+    if (check_current(parser, TOKEN_FUNC)
+        || check_current(parser, TOKEN_HASH_LBRACKET)) {
         return parse_decl_function(parser);
     }
 
@@ -555,6 +560,7 @@ parse_decl_function(struct parser* parser)
 {
     assert(parser != NULL);
 
+    unsigned const attributes = parse_function_attribute_list(parser);
     struct source_location const location =
         expect_current(parser, TOKEN_FUNC).location;
     struct cst_identifier const identifier = parse_identifier(parser);
@@ -573,12 +579,70 @@ parse_decl_function(struct parser* parser)
         template_parameters,
         function_parameters,
         return_type,
-        body);
+        body,
+        attributes);
 
     freeze(product);
     return product;
 }
 
+static unsigned
+parse_function_attribute_list(struct parser* parser)
+{
+    assert(parser != NULL);
+
+    if (!check_current(parser, TOKEN_HASH_LBRACKET)) {
+        return 0u;
+    }
+
+    expect_current(parser, TOKEN_HASH_LBRACKET);
+    unsigned attributes = parse_function_attribute(parser, 0u);
+    while (check_current(parser, TOKEN_COMMA)) {
+        advance_token(parser);
+        attributes = parse_function_attribute(parser, attributes);
+    }
+    expect_current(parser, TOKEN_RBRACKET);
+
+    return attributes;
+}
+
+static unsigned
+parse_function_attribute(struct parser* parser, unsigned attributes)
+{
+    assert(parser != NULL);
+
+    // Attribute names must match the names lexed as attribute lists (see
+    // is_attribute_name in lex.c).
+    static struct {
+        char const* name;
+        enum function_attribute attribute;
+        enum function_attribute conflict;
+    } const table[] = {
+        {"inline", FUNCTION_ATTRIBUTE_INLINE, FUNCTION_ATTRIBUTE_NOINLINE},
+        {"noinline", FUNCTION_ATTRIBUTE_NOINLINE, FUNCTION_ATTRIBUTE_INLINE},
+        {"hot", FUNCTION_ATTRIBUTE_HOT, FUNCTION_ATTRIBUTE_COLD},
+        {"cold", FUNCTION_ATTRIBUTE_COLD, FUNCTION_ATTRIBUTE_HOT},
+    };
+
+    struct cst_identifier const identifier = parse_identifier(parser);
+    for (size_t i = 0; i < ARRAY_COUNT(table); ++i) {
+        if (identifier.name != intern_cstr(table[i].name)) {
+            continue;
+        }
+        if ((attributes & (unsigned)table[i].conflict) != 0) {
+            fatal(
+                identifier.location,
+                "function attribute `%s` conflicts with a previous attribute",
+                identifier.name);
+        }
+        return attributes | (unsigned)table[i].attribute;
+    }
+
+    // Only lists of known attribute names are lexed as attribute lists.
+    UNREACHABLE();
+    return 0u;
+}
+
 static struct cst_decl const*
 parse_decl_struct(struct parser* parser)
 {
@@ -640,7 +704,8 @@ parse_decl_enum(struct parser* parser)
 
     sbuf(struct cst_enum_value const*) values = NULL;
     while (!check_current(parser, TOKEN_RBRACE)
-           && !check_current(parser, TOKEN_FUNC)) {
+           && !check_current(parser, TOKEN_FUNC)
+           && !check_current(parser, TOKEN_HASH_LBRACKET)) {
         sbuf_push(values, parse_enum_value(parser));
     }
     sbuf_freeze(values);
@@ -1942,7 +2007,8 @@ parse_member(struct parser* parser)
         return parse_member_constant(parser);
     }
 
-    if (check_current(parser, TOKEN_FUNC)) {
+    if (check_current(parser, TOKEN_FUNC)
+        || check_current(parser, TOKEN_HASH_LBRACKET)) {
         return parse_member_function(parser);
     }
 
@@ -13,6 +13,10 @@ struct incomplete_function {
     struct function* function;
     struct symbol_table* symbol_table;
     struct template_instantiation_link const* chain; // optional
+    // True while the function body is being resolved. Used to detect a
+    // function that is called during compile-time evaluation from within its
+    // own (incomplete) body.
+    bool is_completing;
 };
 
 struct resolver {
@@ -70,8 +74,13 @@ struct resolver {
     //
     // NOTE: This member must *NOT* be saved/restored because template function
     // instantiations may resize the stretchy buffer.
-    sbuf(struct incomplete_function const*) incomplete_functions;
+    sbuf(struct incomplete_function*) incomplete_functions;
 };
+
+// Resolver of the module currently being resolved. Modules are resolved one at
+// a time, with imported modules resolved to completion before resolution of
+// the importing module continues.
+static struct resolver* active_resolver = NULL;
 static struct resolver*
 resolver_new(struct module* module);
 static void
@@ -230,7 +239,7 @@ complete_enum(
     struct cst_member const* const* member_functions);
 static void
 complete_function(
-    struct resolver* resolver, struct incomplete_function const* incomplete);
+    struct resolver* resolver, struct incomplete_function* incomplete);
 
 static struct block
 resolve_block(
@@ -912,7 +921,8 @@ xget_template_instance(
             instance_template_parameters,
             instance_function_parameters,
             instance_return_type,
-            instance_body);
+            instance_body,
+            decl->data.function.attributes);
         freeze(instance_decl);
 
         struct template_instantiation_link* link = xalloc(NULL, sizeof(*link));
@@ -1583,9 +1593,104 @@ merge_symbol_table(
     }
 }
 
+// The import cache functions below memoize filesystem queries performed while
+// resolving imports so that each query is made at most once per compilation.
+
+static bool
+cached_file_exists(char const* path)
+{
+    assert(path != NULL);
+
+    path = intern_cstr(path);
+    struct pointer_map* const cache = &context()->import_cache.file_exists;
+    char const* result = pointer_map_lookup(cache, path);
+    if (result == NULL) {
+        result = file_exists(path) ? path : context()->interned.empty;
+        pointer_map_insert(cache, path, result);
+    }
+    return result != context()->interned.empty;
+}
+
+static bool
+cached_file_is_directory(char const* path)
+{
+    assert(path != NULL);
+
+    path = intern_cstr(path);
+    struct pointer_map* const cache =
+        &context()->import_cache.file_is_directory;
+    char const* result = pointer_map_lookup(cache, path);
+    if (result == NULL) {
+        result = file_is_directory(path) ? path : context()->interned.empty;
+        pointer_map_insert(cache, path, result);
+    }
+    return result != context()->interned.empty;
+}
+
+static char const* // interned
+cached_directory_path(char const* path)
+{
+    assert(path != NULL);
+
+    path = intern_cstr(path);
+    struct pointer_map* const cache = &context()->import_cache.directory_paths;
+    char const* result = pointer_map_lookup(cache, path);
+    if (result == NULL) {
+        result = directory_path(path);
+        pointer_map_insert(cache, path, result);
+    }
+    return result;
+}
+
+// Returns a frozen list of the files within the provided directory.
+static char const* const*
+cached_directory_files(char const* path)
+{
+    assert(path != NULL);
+
+    path = intern_cstr(path);
+    struct pointer_map* const cache = &context()->import_cache.directory_files;
+    sbuf(char const*) result = (char const**)pointer_map_lookup(cache, path);
+    if (result == NULL) {
+        result = directory_files(path);
+        sbuf_freeze(result);
+        if (result != NULL) {
+            pointer_map_insert(cache, path, result);
+        }
+    }
+    return result;
+}
+
+static char const* const*
+search_path_directories(void)
+{
+    struct context* const ctx = context();
+    if (ctx->import_cache.search_path_directories_initialized) {
+        return ctx->import_cache.search_path_directories;
+    }
+    ctx->import_cache.search_path_directories_initialized = true;
+
+    char const* SUNDER_SEARCH_PATH = getenv("SUNDER_SEARCH_PATH");
+    if (SUNDER_SEARCH_PATH == NULL) {
+        return NULL;
+    }
+    struct string* const tmp = string_new_cstr(SUNDER_SEARCH_PATH);
+    sbuf(struct string*) const imp =
+        string_split(tmp, ":", STR_LITERAL_COUNT(":"));
+    for (size_t i = 0; i < sbuf_count(imp); ++i) {
+        sbuf_push(
+            ctx->import_cache.search_path_directories,
+            intern(string_start(imp[i]), string_count(imp[i])));
+        string_del(imp[i]);
+    }
+    sbuf_fini(imp);
+    string_del(tmp);
+    return ctx->import_cache.search_path_directories;
+}
+
 // Returns the canonical representation of the provided search path or NULL.
 static char const* // interned
-canonical_search_path(char const* module_path, char const* search_path)
+canonical_search_path_uncached(char const* module_path, char const* search_path)
 {
     assert(module_path != NULL);
     assert(search_path != NULL);
@@ -1596,79 +1701,80 @@ canonical_search_path(char const* module_path, char const* search_path)
     search_path =
         cstr_replace(search_path, "{HOST}", context()->env.SUNDER_HOST);
 
-    char const* result = NULL;
-
     // Path relative to the current module.
-    char const* const module_dir = directory_path(module_path);
-    struct string* const tmp = string_new_fmt("%s/%s", module_dir, search_path);
-    if (file_exists(string_start(tmp))) {
-        result = canonical_path(string_start(tmp));
-        string_del(tmp);
-        return result;
+    char const* const module_dir = cached_directory_path(module_path);
+    char const* path = intern_fmt("%s/%s", module_dir, search_path);
+    if (cached_file_exists(path)) {
+        return canonical_path(path);
     }
 
     // Path relative to environment-defined search path-list.
-    char const* SUNDER_SEARCH_PATH = getenv("SUNDER_SEARCH_PATH");
-    if (SUNDER_SEARCH_PATH == NULL) {
-        string_del(tmp);
-        return NULL;
+    char const* const* const directories = search_path_directories();
+    for (size_t i = 0; i < sbuf_count(directories); ++i) {
+        path = intern_fmt("%s/%s", directories[i], search_path);
+        if (cached_file_exists(path)) {
+            return canonical_path(path); // Found the module.
+        }
     }
-    string_resize(tmp, 0u);
-    string_append_cstr(tmp, SUNDER_SEARCH_PATH);
-
-    sbuf(struct string*) const imp =
-        string_split(tmp, ":", STR_LITERAL_COUNT(":"));
-    for (size_t i = 0; i < sbuf_count(imp); ++i) {
-        struct string* const s = imp[i];
-
-        string_resize(tmp, 0u);
-        string_append_fmt(tmp, "%s/%s", string_start(s), search_path);
 
-        if (!file_exists(string_start(tmp))) {
-            continue;
-        }
+    return NULL;
+}
 
-        result = canonical_path(string_start(tmp));
-        break; // Found the module.
-    }
+// Returns the canonical representation of the provided search path or NULL.
+static char const* // interned
+canonical_search_path(char const* module_path, char const* search_path)
+{
+    assert(module_path != NULL);
+    assert(search_path != NULL);
 
-    string_del(tmp);
-    for (size_t i = 0; i < sbuf_count(imp); ++i) {
-        string_del(imp[i]);
+    // Search paths are resolved relative to the directory of the importing
+    // module, so modules within the same directory share cache entries.
+    char const* const key = intern_fmt(
+        "%s\n%s", cached_directory_path(module_path), search_path);
+    struct pointer_map* const cache = &context()->import_cache.search_paths;
+    char const* result = pointer_map_lookup(cache, key);
+    if (result == NULL) {
+        result = canonical_search_path_uncached(module_path, search_path);
+        pointer_map_insert(
+            cache, key, result != NULL ? result : context()->interned.empty);
+        return result;
     }
-    sbuf_fini(imp);
-    return result;
+    return result != context()->interned.empty ? result : NULL;
 }
 
-static void
-resolve_import_file(
-    struct resolver* resolver,
-    struct source_location location,
+static char const*
+collect_import_files(
+    char const* module_path,
     char const* file_name,
-    bool from_directory)
+    bool from_directory,
+    sbuf(struct import_file)* files)
 {
-    assert(resolver != NULL);
+    assert(module_path != NULL);
     assert(file_name != NULL);
+    assert(files != NULL);
 
-    char const* const path =
-        canonical_search_path(resolver->module->path, file_name);
+    char const* const path = canonical_search_path(module_path, file_name);
     if (path == NULL) {
-        fatal(location, "failed to resolve import `%s`", file_name);
+        return file_name;
     }
 
-    if (file_is_directory(path)) {
-        sbuf(char const*) dir_contents = directory_files(path);
+    if (cached_file_is_directory(path)) {
+        char const* failed = NULL;
+        char const* const* const dir_contents = cached_directory_files(path);
         for (size_t i = 0; i < sbuf_count(dir_contents); ++i) {
             struct string* const string =
                 string_new_fmt("%s/%s", file_name, dir_contents[i]);
             char const* const interned = intern_cstr(string_start(string));
             string_del(string);
-            if (!file_is_directory(interned)) {
-                resolve_import_file(resolver, location, interned, true);
+            if (!cached_file_is_directory(interned)) {
+                failed =
+                    collect_import_files(module_path, interned, true, files);
+            }
+            if (failed != NULL) {
+                break;
             }
         }
-        sbuf_fini(dir_contents);
-        return;
+        return failed;
     }
 
     if (from_directory && !cstr_ends_with(file_name, ".sunder")) {
@@ -1677,12 +1783,12 @@ resolve_import_file(
         // non-Sunder files to be imported without the compiler producing an
         // error from trying to load something like `.txt` file as a Sunder
         // module.
-        return;
+        return NULL;
     }
 
     if (from_directory && cstr_ends_with(file_name, ".test.sunder")) {
         // Ignore test files imported via a directory import.
-        return;
+        return NULL;
     }
 
     // For a Sunder directory "foo" containing the sources files:
@@ -1726,27 +1832,35 @@ resolve_import_file(
         bool const matches_target = (0 == strcmp(start, platform))
             || (0 == strcmp(start, arch)) || (0 == strcmp(start, host));
         if (!matches_target) {
-            return;
+            return NULL;
         }
     }
     if (from_directory && !is_special_file) {
         bool const platform_specific_file_exists =
-            file_exists(intern_fmt("%s.%s.sunder", stem, platform))
-            || file_exists(intern_fmt("%s.%s.sunder", stem, arch))
-            || file_exists(intern_fmt("%s.%s.sunder", stem, host));
+            cached_file_exists(intern_fmt("%s.%s.sunder", stem, platform))
+            || cached_file_exists(intern_fmt("%s.%s.sunder", stem, arch))
+            || cached_file_exists(intern_fmt("%s.%s.sunder", stem, host));
         if (platform_specific_file_exists) {
-            return;
+            return NULL;
         }
     }
 
-    struct module const* module = lookup_module(path);
-    if (module == NULL) {
-        module = load_module(file_name, path);
-    }
-    if (!module->loaded) {
-        fatal(location, "circular dependency when importing `%s`", file_name);
-    }
-    merge_symbol_table(resolver, resolver->module->symbols, module->exports);
+    struct import_file const file = {file_name, path};
+    sbuf_push(*files, file);
+    return NULL;
+}
+
+char const*
+resolve_import_files(
+    char const* module_path,
+    char const* file_name,
+    sbuf(struct import_file)* files)
+{
+    assert(module_path != NULL);
+    assert(file_name != NULL);
+    assert(files != NULL);
+
+    return collect_import_files(module_path, file_name, false, files);
 }
 
 static void
@@ -1755,7 +1869,28 @@ resolve_import(struct resolver* resolver, struct cst_import const* import)
     assert(resolver != NULL);
     assert(import != NULL);
 
-    resolve_import_file(resolver, import->location, import->path, false);
+    sbuf(struct import_file) files = NULL;
+    char const* const failed =
+        resolve_import_files(resolver->module->path, import->path, &files);
+    if (failed != NULL) {
+        fatal(import->location, "failed to resolve import `%s`", failed);
+    }
+
+    for (size_t i = 0; i < sbuf_count(files); ++i) {
+        struct module const* module = lookup_module(files[i].path);
+        if (module == NULL) {
+            module = load_module(files[i].name, files[i].path);
+        }
+        if (!module->loaded) {
+            fatal(
+                import->location,
+                "circular dependency when importing `%s`",
+                files[i].name);
+        }
+        merge_symbol_table(
+            resolver, resolver->module->symbols, module->exports);
+    }
+    sbuf_fini(files);
 }
 
 static struct symbol const*
@@ -2012,6 +2147,7 @@ resolve_decl_function(struct resolver* resolver, struct cst_decl const* decl)
     struct value* const value = value_new_function(function);
     value_freeze(value);
     function->value = value;
+    function->attributes = decl->data.function.attributes;
 
     // Add the function/value to the symbol table now so that recursive
     // functions may reference themselves.
@@ -2089,7 +2225,8 @@ resolve_decl_function(struct resolver* resolver, struct cst_decl const* decl)
         .name = function_symbol->name,
         .function = function,
         .symbol_table = symbol_table,
-        .chain = context()->template_instantiation_chain};
+        .chain = context()->template_instantiation_chain,
+        .is_completing = false};
     freeze(incomplete);
     sbuf_push(resolver->incomplete_functions, incomplete);
 
@@ -3052,7 +3189,7 @@ complete_enum(
 
 static void
 complete_function(
-    struct resolver* resolver, struct incomplete_function const* incomplete)
+    struct resolver* resolver, struct incomplete_function* incomplete)
 {
     assert(resolver != NULL);
     assert(incomplete != NULL);
@@ -3062,6 +3199,8 @@ complete_function(
     context()->template_instantiation_chain = incomplete->chain;
 
     struct function* const function = incomplete->function;
+    assert(!function->is_complete);
+    incomplete->is_completing = true;
 
     // Complete the function.
     assert(resolver->current_function == NULL);
@@ -3117,9 +3256,60 @@ complete_function(
             "Non-void-returning function does not end with a return statement");
     }
 
+    incomplete->is_completing = false;
+    function->is_complete = true;
     context()->template_instantiation_chain = save_chain;
 }
 
+void
+resolve_complete_function(
+    struct source_location location, struct function const* function)
+{
+    assert(function != NULL);
+
+    if (function->is_complete) {
+        return;
+    }
+
+    struct resolver* const resolver = active_resolver;
+    struct incomplete_function* incomplete = NULL;
+    for (size_t i = 0; resolver != NULL
+         && i < sbuf_count(resolver->incomplete_functions);
+         ++i) {
+        if (resolver->incomplete_functions[i]->function == function) {
+            incomplete = resolver->incomplete_functions[i];
+            break;
+        }
+    }
+    if (incomplete == NULL || incomplete->is_completing) {
+        fatal(
+            location,
+            "function `%s` called during compile-time evaluation before its definition is complete",
+            function->address->data.static_.name);
+    }
+
+    // Functions completed on demand may be completed from within the body of
+    // another function, so the per-function resolver state is saved and reset
+    // for the duration of the completion.
+    struct resolver const save = *resolver;
+    resolver->current_type = NULL;
+    resolver->current_function = NULL;
+    resolver->current_local_counter = 0;
+    resolver->is_within_constant_decl = false;
+    resolver->is_within_loop = false;
+    resolver->current_loop_defer = NULL;
+    resolver->current_defer = NULL;
+
+    complete_function(resolver, incomplete);
+
+    // Template instantiations may have resized the incomplete functions
+    // stretchy buffer, so it is the only member not restored.
+    sbuf(struct incomplete_function*) const incomplete_functions =
+        resolver->incomplete_functions;
+    *resolver = save;
+    resolver->incomplete_functions = incomplete_functions;
+}
+
 static struct block
 resolve_block(
     struct resolver* resolver,
@@ -6469,6 +6659,8 @@ resolve(struct module* module)
     assert(module != NULL);
 
     struct resolver* const resolver = resolver_new(module);
+    struct resolver* const save_active_resolver = active_resolver;
+    active_resolver = resolver;
 
     // Module namespace.
     if (module->cst->namespace != NULL) {
@@ -6612,8 +6804,16 @@ resolve(struct module* module)
     }
 
     for (size_t i = 0; i < sbuf_count(resolver->incomplete_functions); ++i) {
-        complete_function(resolver, resolver->incomplete_functions[i]);
+        struct incomplete_function* const incomplete =
+            resolver->incomplete_functions[i];
+        if (incomplete->function->is_complete) {
+            // Function was completed on demand during compile-time
+            // evaluation.
+            continue;
+        }
+        complete_function(resolver, incomplete);
     }
 
+    active_resolver = save_active_resolver;
     resolver_del(resolver);
 }
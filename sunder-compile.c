@@ -1,10 +1,18 @@
 // SPDX-License-Identifier: Apache-2.0
-#define _XOPEN_SOURCE /* getopt */
+#define _XOPEN_SOURCE 700 /* getopt, setenv, unsetenv */
+#include <assert.h>
+#include <errno.h>
+#include <limits.h> /* PATH_MAX */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h> /* struct timespec */
 
-#include <unistd.h> /* getopt */
+#include <sys/socket.h> /* socket, bind, listen, accept, connect, shutdown */
+#include <sys/stat.h> /* struct stat, stat, lstat, umask */
+#include <sys/un.h> /* struct sockaddr_un */
+#include <sys/wait.h> /* waitpid */
+#include <unistd.h> /* getopt, getcwd, chdir, fork, dup2, execvp */
 
 #include "sunder.h"
 
@@ -31,18 +39,38 @@ static void
 usage(void);
 static void
 argparse(int argc, char** argv);
+static int
+compile(void);
 static void
 fini(void);
 
+static NORETURN void
+server(int argc, char** argv);
+static int
+client(int argc, char** argv);
+
 int
 main(int argc, char** argv)
 {
     atexit(fini);
+    if (argc >= 2 && 0 == strcmp(argv[1], "--connect")) {
+        return client(argc, argv);
+    }
+
     context_init();
     atexit(context_fini);
 
+    if (argc >= 2 && 0 == strcmp(argv[1], "--server")) {
+        server(argc, argv);
+    }
+
     argparse(argc, argv);
+    return compile();
+}
 
+static int
+compile(void)
+{
     load_module(path, canonical_path(path));
     if (!opt_c) {
         validate_main_is_defined_correctly();
@@ -70,6 +98,15 @@ usage(void)
     // clang-format off
     char const* const lines[] = {
    "Usage: sunder-compile [OPTION...] FILE",
+   "       sunder-compile --server SOCKET PRELUDE",
+   "       sunder-compile --connect SOCKET [OPTION...] FILE",
+   "",
+   "Server Mode:",
+   "  --server SOCKET PRELUDE",
+   "            Listen for compile requests on the Unix socket SOCKET, keeping",
+   "            the modules imported by PRELUDE loaded between requests.",
+   "  --connect SOCKET",
+   "            Compile using the server listening on the Unix socket SOCKET.",
    "",
    "Options:",
    "  -c        Compile and assemble, but do not link.",
@@ -201,3 +238,541 @@ fini(void)
     sbuf_fini(opt_l);
     sbuf_fini(paths);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Compile server.
+//
+// A compile server loads the modules imported by a prelude file once, and then
+// serves each compile request in a forked child process, so that requests
+// start from the already loaded and resolved modules instead of from a cold
+// process. Diagnostics are produced by the child exactly as they would be by
+// a standalone compilation.
+//
+// A request is a sequence of NUL-terminated strings sent by the client, after
+// which the client shuts down its side of the connection for writing:
+//
+//      CWD NAME=VALUE... "" ARG...
+//
+// where CWD is the working directory of the client, NAME=VALUE is an
+// environment variable from `request_env_names` set for the client, and the
+// ARGs are the command line arguments of the client following the socket
+// path. The response consists of the merged standard output and standard
+// error of the compilation followed by a single byte holding the exit status.
+//
+// Requests are served from a cold process when they cannot use the loaded
+// modules: if the client Sunder environment differs from that of the server,
+// if the input file is one of the loaded modules, or if -c is specified, as
+// unlinked object files contain every symbol of every loaded module. When the
+// source of a loaded module (or the contents of its directory) is modified,
+// the request is served cold and the server restarts itself. The listening
+// socket is passed to the restarted server through the environment variable
+// SERVER_LISTENER_ENV, so that clients connecting during the restart wait for
+// the restarted server to accept their connections.
+
+#define SERVER_LISTENER_ENV "SUNDER_SERVER_LISTENER"
+
+static char const* const request_env_names[] = {
+    "SUNDER_HOME",
+    "SUNDER_ARCH",
+    "SUNDER_HOST",
+    "SUNDER_SEARCH_PATH",
+    "SUNDER_CC",
+    "SUNDER_CFLAGS",
+    "PATH",
+};
+
+struct server_module {
+    struct module const* module;
+    struct timespec mtime;
+    struct timespec directory_mtime;
+};
+
+// clang-format off
+static char const*                 server_executable = NULL;
+static char const*                 server_env = NULL; // Sunder environment.
+static size_t                      server_env_count = 0;
+static bool                        server_preloaded = false;
+static sbuf(struct server_module)  server_modules = NULL;
+// clang-format on
+
+static int
+socket_new(char const* socket_path, struct sockaddr_un* addr)
+{
+    assert(socket_path != NULL);
+    assert(addr != NULL);
+
+    if (strlen(socket_path) >= sizeof(addr->sun_path)) {
+        fatal(NO_LOCATION, "socket path `%s` is too long", socket_path);
+    }
+    memset(addr, 0x00, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, socket_path);
+
+    int const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        fatal(
+            NO_LOCATION,
+            "failed to create socket with error '%s'",
+            strerror(errno));
+    }
+    return fd;
+}
+
+static bool
+write_all(int fd, void const* buf, size_t buf_size)
+{
+    char const* cur = buf;
+    while (buf_size != 0) {
+        ssize_t const written = write(fd, cur, buf_size);
+        if (written == -1 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        cur += written;
+        buf_size -= (size_t)written;
+    }
+    return true;
+}
+
+// Read from fd until end-of-file.
+static struct string*
+read_all(int fd)
+{
+    struct string* const result = string_new(NULL, 0);
+    char buf[4096] = {0};
+    while (true) {
+        ssize_t const nread = read(fd, buf, sizeof(buf));
+        if (nread == -1 && errno == EINTR) {
+            continue;
+        }
+        if (nread <= 0) {
+            return result;
+        }
+        string_append(result, buf, (size_t)nread);
+    }
+}
+
+// Append the request environment of the current process to s. If sunder_only
+// is true then only the Sunder environment variables are appended.
+static void
+append_request_env(struct string* s, bool sunder_only)
+{
+    assert(s != NULL);
+
+    for (size_t i = 0; i < ARRAY_COUNT(request_env_names); ++i) {
+        char const* const name = request_env_names[i];
+        char const* const value = getenv(name);
+        bool const skip =
+            sunder_only && !cstr_starts_with(name, "SUNDER_");
+        if (value == NULL || skip) {
+            continue;
+        }
+        string_append_fmt(s, "%s=%s", name, value);
+        string_append(s, "", 1);
+    }
+}
+
+static int
+client(int argc, char** argv)
+{
+    if (argc < 3) {
+        fatal(NO_LOCATION, "missing socket path for --connect");
+    }
+
+    struct sockaddr_un addr;
+    int const fd = socket_new(argv[2], &addr);
+    if (connect(fd, (struct sockaddr const*)&addr, sizeof(addr)) == -1) {
+        fatal(
+            NO_LOCATION,
+            "failed to connect to `%s` with error '%s'",
+            argv[2],
+            strerror(errno));
+    }
+
+    char cwd[PATH_MAX] = {0};
+    if (getcwd(cwd, sizeof(cwd)) == NULL) {
+        fatal(
+            NO_LOCATION,
+            "failed to get the current working directory with error '%s'",
+            strerror(errno));
+    }
+
+    struct string* const request = string_new(cwd, strlen(cwd) + 1);
+    append_request_env(request, false);
+    string_append(request, "", 1);
+    for (int i = 3; i < argc; ++i) {
+        string_append(request, argv[i], strlen(argv[i]) + 1);
+    }
+    if (!write_all(fd, string_start(request), string_count(request))) {
+        fatal(
+            NO_LOCATION,
+            "failed to send request to `%s` with error '%s'",
+            argv[2],
+            strerror(errno));
+    }
+    string_del(request);
+    (void)shutdown(fd, SHUT_WR);
+
+    struct string* const response = read_all(fd);
+    (void)close(fd);
+    size_t const count = string_count(response);
+    if (count == 0) {
+        fatal(NO_LOCATION, "connection to `%s` closed by server", argv[2]);
+    }
+    (void)fwrite(string_start(response), 1, count - 1, stderr);
+    int const status = (unsigned char)string_start(response)[count - 1];
+    string_del(response);
+    return status;
+}
+
+static bool
+timespec_eq(struct timespec a, struct timespec b)
+{
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+// Returns true if the source of any loaded module, or the contents of the
+// directory containing any loaded module, has been modified since the module
+// was loaded.
+static bool
+server_modules_stale(void)
+{
+    for (size_t i = 0; i < sbuf_count(server_modules); ++i) {
+        struct server_module* const loaded = &server_modules[i];
+        struct module const* const module = loaded->module;
+
+        struct stat statbuf = {0};
+        if (stat(directory_path(module->path), &statbuf) != 0
+            || !timespec_eq(statbuf.st_mtim, loaded->directory_mtime)) {
+            return true;
+        }
+        if (stat(module->path, &statbuf) != 0) {
+            return true;
+        }
+        if (timespec_eq(statbuf.st_mtim, loaded->mtime)) {
+            continue;
+        }
+
+        // The modification time may change without the source changing, e.g.
+        // when the build system touches the file.
+        void* text = NULL;
+        size_t text_size = 0;
+        if (file_read_all(module->path, &text, &text_size)) {
+            return true;
+        }
+        bool const unchanged = text_size == module->source_count
+            && safe_memcmp(text, module->source, text_size) == 0;
+        xalloc(text, XALLOC_FREE);
+        if (!unchanged) {
+            return true;
+        }
+        loaded->mtime = statbuf.st_mtim;
+    }
+    return false;
+}
+
+// Load the modules imported by the prelude. The prelude itself is not loaded,
+// so any declarations within the prelude (e.g. `main`) do not conflict with
+// the declarations of the files compiled by the server.
+static void
+server_preload(char const* prelude)
+{
+    assert(prelude != NULL);
+
+    struct module* const module = module_new(prelude, canonical_path(prelude));
+    parse(module);
+    sbuf(struct cst_import const* const) const imports = module->cst->imports;
+    for (size_t i = 0; i < sbuf_count(imports); ++i) {
+        sbuf(struct import_file) files = NULL;
+        char const* const failed =
+            resolve_import_files(module->path, imports[i]->path, &files);
+        if (failed != NULL) {
+            fatal(
+                imports[i]->location,
+                "failed to resolve import `%s`",
+                failed);
+        }
+        for (size_t j = 0; j < sbuf_count(files); ++j) {
+            if (lookup_module(files[j].path) == NULL) {
+                load_module(files[j].name, files[j].path);
+            }
+        }
+        sbuf_fini(files);
+    }
+    module_del(module);
+
+    for (size_t i = 0; i < sbuf_count(context()->modules); ++i) {
+        struct module const* const loaded = context()->modules[i];
+        struct stat statbuf = {0};
+        struct stat dirbuf = {0};
+        if (stat(loaded->path, &statbuf) != 0
+            || stat(directory_path(loaded->path), &dirbuf) != 0) {
+            fatal(
+                NO_LOCATION,
+                "failed to stat '%s' with error '%s'",
+                loaded->path,
+                strerror(errno));
+        }
+        struct server_module const server_module = {
+            loaded, statbuf.st_mtim, dirbuf.st_mtim};
+        sbuf_push(server_modules, server_module);
+    }
+}
+
+static void
+server_preload_speculative(void* prelude)
+{
+    server_preload(prelude);
+}
+
+// Replace the current process with a standalone compilation of the request.
+static NORETURN void
+serve_cold(char** argv)
+{
+    assert(argv != NULL);
+
+    argv[0] = (char*)server_executable;
+    (void)execvp(argv[0], argv);
+    fatal(
+        NO_LOCATION,
+        "failed to execvp '%s' with error '%s'",
+        argv[0],
+        strerror(errno));
+}
+
+// Serve the request on the provided connection. Called in a child process of
+// the server. Does not return.
+static NORETURN void
+serve(int conn, bool stale)
+{
+    struct string* const request = read_all(conn);
+    char const* cur = string_start(request);
+    char const* const end = cur + string_count(request);
+
+    // Requests are sequences of NUL-terminated strings.
+    sbuf(char const*) strings = NULL;
+    while (cur != end) {
+        char const* const nul = memchr(cur, '\0', (size_t)(end - cur));
+        if (nul == NULL) {
+            _exit(EXIT_FAILURE); // Malformed request.
+        }
+        sbuf_push(strings, cur);
+        cur = nul + 1;
+    }
+    size_t index = 0;
+    if (sbuf_count(strings) == 0) {
+        _exit(EXIT_FAILURE); // Malformed request.
+    }
+    char const* const cwd = strings[index++];
+    for (size_t i = 0; i < ARRAY_COUNT(request_env_names); ++i) {
+        (void)unsetenv(request_env_names[i]);
+    }
+    while (index < sbuf_count(strings) && *strings[index] != '\0') {
+        char const* const entry = strings[index++];
+        char const* const equals = strchr(entry, '=');
+        if (equals == NULL) {
+            _exit(EXIT_FAILURE); // Malformed request.
+        }
+        char const* const name = intern(entry, (size_t)(equals - entry));
+        (void)setenv(name, equals + 1, 1);
+    }
+    if (index == sbuf_count(strings)) {
+        _exit(EXIT_FAILURE); // Malformed request.
+    }
+    index += 1; // Skip the end of the environment.
+
+    // Arguments of the compilation, prefixed with a placeholder for argv[0].
+    sbuf(char*) argv = NULL;
+    sbuf_push(argv, (char*)server_executable);
+    for (; index < sbuf_count(strings); ++index) {
+        sbuf_push(argv, (char*)strings[index]);
+    }
+    sbuf_push(argv, NULL);
+    int const argc = (int)sbuf_count(argv) - 1;
+
+    pid_t const pid = fork();
+    if (pid == -1) {
+        _exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+        (void)dup2(conn, STDOUT_FILENO);
+        (void)dup2(conn, STDERR_FILENO);
+        (void)close(conn);
+        if (chdir(cwd) != 0) {
+            fatal(
+                NO_LOCATION,
+                "failed to change directory to '%s' with error '%s'",
+                cwd,
+                strerror(errno));
+        }
+
+        struct string* const env = string_new(NULL, 0);
+        append_request_env(env, true);
+        bool const same_env = string_count(env) == server_env_count
+            && safe_memcmp(string_start(env), server_env, server_env_count)
+                == 0;
+        if (stale || !same_env) {
+            serve_cold(argv);
+        }
+        string_del(env);
+
+        argparse(argc, argv);
+        if (opt_c || lookup_module(canonical_path(path)) != NULL) {
+            serve_cold(argv);
+        }
+        exit(compile());
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+        continue;
+    }
+    unsigned char const code =
+        WIFEXITED(status) ? (unsigned char)WEXITSTATUS(status) : EXIT_FAILURE;
+    (void)write_all(conn, &code, sizeof(code));
+    _exit(EXIT_SUCCESS);
+}
+
+// Returns the listening socket of the server. A restarted server continues to
+// listen on the socket inherited from the server it replaced. Otherwise the
+// socket is created so that only the owner of the server may connect to it, as
+// requests run with the privileges of the server.
+static int
+server_listen(char const* socket_path)
+{
+    assert(socket_path != NULL);
+
+    char const* const inherited = getenv(SERVER_LISTENER_ENV);
+    if (inherited != NULL) {
+        char* end = NULL;
+        errno = 0;
+        long const fd = strtol(inherited, &end, 10);
+        if (errno != 0 || *end != '\0' || fd < 0 || fd > INT_MAX) {
+            fatal(
+                NO_LOCATION,
+                "invalid %s `%s`",
+                SERVER_LISTENER_ENV,
+                inherited);
+        }
+        (void)unsetenv(SERVER_LISTENER_ENV);
+        return (int)fd;
+    }
+
+    struct sockaddr_un addr;
+    int const listener = socket_new(socket_path, &addr);
+
+    // Only a socket left behind by a server that is no longer running is
+    // replaced. Any other file at the socket path (e.g. a source file passed
+    // as SOCKET by mistake) is left untouched.
+    struct stat st;
+    if (lstat(socket_path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fatal(NO_LOCATION, "`%s` exists and is not a socket", socket_path);
+        }
+        int const probe = socket_new(socket_path, &addr);
+        int const connected =
+            connect(probe, (struct sockaddr const*)&addr, sizeof(addr));
+        (void)close(probe);
+        if (connected == 0) {
+            fatal(
+                NO_LOCATION,
+                "a server is already listening on `%s`",
+                socket_path);
+        }
+        (void)unlink(socket_path);
+    }
+
+    mode_t const mask = umask(S_IXUSR | S_IRWXG | S_IRWXO); // 0600
+    int const bound =
+        bind(listener, (struct sockaddr const*)&addr, sizeof(addr));
+    (void)umask(mask);
+    if (bound == -1 || listen(listener, SOMAXCONN) == -1) {
+        fatal(
+            NO_LOCATION,
+            "failed to listen on `%s` with error '%s'",
+            socket_path,
+            strerror(errno));
+    }
+    return listener;
+}
+
+static NORETURN void
+server(int argc, char** argv)
+{
+    if (argc != 4) {
+        fatal(NO_LOCATION, "expected arguments --server SOCKET PRELUDE");
+    }
+    char const* const socket_path = argv[2];
+
+    // Cold compilations and restarts execute the same compiler as the server.
+    // Relative paths must be resolved up front as requests execute from the
+    // working directory of the client.
+    server_executable =
+        strchr(argv[0], '/') != NULL ? canonical_path(argv[0]) : argv[0];
+
+    struct string* const env = string_new(NULL, 0);
+    append_request_env(env, true);
+    server_env = intern(string_start(env), string_count(env));
+    server_env_count = string_count(env);
+    string_del(env);
+
+    // The socket is created before the modules are loaded, so that clients
+    // may connect (and wait to be served) while the server is starting.
+    int const listener = server_listen(socket_path);
+
+    // If the prelude or one of its imports cannot be loaded (e.g. a source
+    // file was modified with an error before a restart), then requests are
+    // served cold, and the server restarts after each request until the
+    // modules can be loaded again.
+    server_preloaded = speculate(server_preload_speculative, argv[3]);
+    if (!server_preloaded) {
+        warning(
+            NO_LOCATION,
+            "failed to load the imports of `%s`; serving requests cold",
+            argv[3]);
+    }
+
+    while (true) {
+        // Reap the processes of completed requests.
+        while (waitpid(-1, NULL, WNOHANG) > 0) {
+            continue;
+        }
+
+        int const conn = accept(listener, NULL, NULL);
+        if (conn == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            fatal(
+                NO_LOCATION,
+                "failed to accept connection with error '%s'",
+                strerror(errno));
+        }
+
+        bool const stale = !server_preloaded || server_modules_stale();
+        (void)fflush(NULL);
+        pid_t const pid = fork();
+        if (pid == 0) {
+            (void)close(listener);
+            serve(conn, stale);
+        }
+        (void)close(conn);
+
+        if (stale) {
+            // Restart the server so that the modified modules are reloaded.
+            // The listening socket remains open across the exec.
+            struct string* const fd = string_new_fmt("%d", listener);
+            (void)setenv(SERVER_LISTENER_ENV, string_start(fd), 1);
+            string_del(fd);
+            argv[0] = (char*)server_executable;
+            (void)execvp(argv[0], argv);
+            fatal(
+                NO_LOCATION,
+                "failed to execvp '%s' with error '%s'",
+                argv[0],
+                strerror(errno));
+        }
+    }
+}
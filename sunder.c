@@ -364,10 +364,26 @@ context_fini(void)
 #ifndef NDEBUG
     struct context* const self = &s_context;
 
+    for (size_t i = 0; i < sbuf_count(self->preparsed); ++i) {
+        struct module* const module = self->preparsed[i];
+        if (lookup_module(module->path) != module) {
+            module_del(module); // Never loaded.
+        }
+    }
+    sbuf_fini(self->preparsed);
     for (size_t i = 0; i < sbuf_count(self->modules); ++i) {
         module_del(self->modules[i]);
     }
     sbuf_fini(self->modules);
+    pointer_map_fini(&self->module_paths);
+    pointer_map_fini(&self->preparsed_paths);
+
+    pointer_map_fini(&self->import_cache.search_paths);
+    pointer_map_fini(&self->import_cache.directory_paths);
+    pointer_map_fini(&self->import_cache.directory_files);
+    pointer_map_fini(&self->import_cache.file_exists);
+    pointer_map_fini(&self->import_cache.file_is_directory);
+    sbuf_fini(self->import_cache.search_path_directories);
 
     intern_fini();
 
@@ -394,16 +410,124 @@ context(void)
     return &s_context;
 }
 
+struct preparse_module_new {
+    char const* name;
+    char const* path;
+    struct module* result;
+};
+
+static void
+preparse_module_new(void* arg)
+{
+    struct preparse_module_new* const self = arg;
+    self->result = module_new(self->name, self->path);
+}
+
+static void
+preparse_module(void* module)
+{
+    parse(module);
+}
+
+static void
+preparse_module_worker(void* modules, size_t index)
+{
+    struct module* const module = ((struct module**)modules)[index];
+    if (!speculate(preparse_module, module)) {
+        // Partially constructed syntax trees are never attached to the
+        // module, so an abandoned parse leaves the module without a CST.
+        assert(module->cst == NULL);
+    }
+}
+
+// Parse the modules transitively imported by the provided module ahead of
+// resolution. Each level of the import graph is parsed in parallel. Modules
+// that cannot be parsed without producing a diagnostic are discarded and will
+// be parsed again when they are loaded during resolution, so diagnostics are
+// reported in the same order as if no modules were parsed ahead of time.
+static void
+preparse_imports(struct module const* module)
+{
+    assert(module != NULL);
+    assert(module->cst != NULL);
+
+    sbuf(struct module const*) frontier = NULL;
+    sbuf(struct module*) level = NULL;
+    sbuf(struct import_file) files = NULL;
+    sbuf_push(frontier, module);
+    while (sbuf_count(frontier) != 0) {
+        for (size_t i = 0; i < sbuf_count(frontier); ++i) {
+            sbuf(struct cst_import const* const) const imports =
+                frontier[i]->cst->imports;
+            for (size_t j = 0; j < sbuf_count(imports); ++j) {
+                sbuf_resize(files, 0);
+                char const* const failed = resolve_import_files(
+                    frontier[i]->path, imports[j]->path, &files);
+                if (failed != NULL) {
+                    continue; // Reported during resolution.
+                }
+
+                for (size_t k = 0; k < sbuf_count(files); ++k) {
+                    char const* const path = files[k].path;
+                    bool const seen = lookup_module(path) != NULL
+                        || pointer_map_lookup(&s_context.preparsed_paths, path)
+                            != NULL;
+                    if (seen) {
+                        continue;
+                    }
+
+                    struct preparse_module_new args = {
+                        files[k].name, path, NULL};
+                    if (!speculate(preparse_module_new, &args)) {
+                        continue;
+                    }
+                    sbuf_push(level, args.result);
+                    sbuf_push(s_context.preparsed, args.result);
+                    pointer_map_insert(
+                        &s_context.preparsed_paths, path, args.result);
+                }
+            }
+        }
+
+        parallel_for(sbuf_count(level), preparse_module_worker, level);
+
+        sbuf_resize(frontier, 0);
+        for (size_t i = 0; i < sbuf_count(level); ++i) {
+            if (level[i]->cst != NULL) {
+                sbuf_push(frontier, level[i]);
+            }
+        }
+        sbuf_resize(level, 0);
+    }
+
+    sbuf_fini(files);
+    sbuf_fini(level);
+    sbuf_fini(frontier);
+}
+
 struct module const*
 load_module(char const* name, char const* path)
 {
     assert(path != NULL);
     assert(lookup_module(path) == NULL);
 
-    struct module* const module = module_new(name, path);
-    sbuf_push(s_context.modules, module);
+    // Modules parsed ahead of resolution have already had their imports
+    // parsed ahead of resolution as well. Modules whose parse was abandoned
+    // are parsed again here so that any diagnostics are reported.
+    struct module* module =
+        (struct module*)pointer_map_lookup(&s_context.preparsed_paths, path);
+    if (module != NULL && module->cst != NULL) {
+        module->name = intern_cstr(name);
+        sbuf_push(s_context.modules, module);
+    }
+    else {
+        module = module_new(name, path);
+        sbuf_push(s_context.modules, module);
+        parse(module);
+        preparse_imports(module);
+    }
+    pointer_map_insert(&s_context.module_paths, path, module);
 
-    parse(module);
     order(module);
     resolve(module);
 
@@ -416,12 +540,7 @@ lookup_module(char const* path)
 {
     assert(path != NULL);
 
-    for (size_t i = 0; i < sbuf_count(context()->modules); ++i) {
-        if (context()->modules[i]->path == path) {
-            return context()->modules[i];
-        }
-    }
-    return NULL;
+    return pointer_map_lookup(&context()->module_paths, path);
 }
 
 void
@@ -317,6 +317,33 @@ void* sbuf__rsz_(size_t elemsize, void* sbuf, size_t cnt);
 void* sbuf__grw_(size_t elemsize, void* sbuf);
 // clang-format on
 
+// Open-addressed hash map from pointer keys to pointer values. Keys are
+// compared by identity, which is sufficient for interned strings, symbols, and
+// uniqued types. A zero-initialized map is empty.
+struct pointer_map_element {
+    void const* key; // Optional (NULL indicates the element is not in use).
+    void const* val;
+};
+struct pointer_map {
+    sbuf(struct pointer_map_element) elements;
+    size_t count;
+};
+// Returns the value associated with key, or NULL if key is not in the map.
+void const*
+pointer_map_lookup(struct pointer_map const* map, void const* key);
+// Associate the non-NULL val with the non-NULL key. Returns true if the key was
+// newly inserted into the map. Returns false without modifying the map if the
+// key was already in the map.
+bool
+pointer_map_insert(struct pointer_map* map, void const* key, void const* val);
+// Associate the non-NULL val with the non-NULL key, replacing any value
+// previously associated with the key.
+void
+pointer_map_assign(struct pointer_map* map, void const* key, void const* val);
+// Free resources associated with the map and reset it to the empty map.
+void
+pointer_map_fini(struct pointer_map* map);
+
 // Allocate and initialize a bit array with count bits.
 // The bit array is initially zeroed.
 struct bitarr*
@@ -660,6 +687,20 @@ NORETURN void
 unreachable(char const* file, int line);
 #define UNREACHABLE() unreachable(__FILE__, __LINE__)
 
+// Call fn(arg) speculatively on the calling thread. If fn would produce any
+// diagnostic (info, warning, error, or fatal) then the diagnostic is
+// suppressed, fn is abandoned at that point, and false is returned. Returns
+// true if fn completed without producing a diagnostic.
+//
+// Memory allocated by abandoned work is not reclaimed until program exit.
+bool
+speculate(void (*fn)(void*), void* arg);
+
+// Call fn(arg, index) for every index in the range [0, count) using a pool of
+// up to one thread per online processor. Returns after all calls complete.
+void
+parallel_for(size_t count, void (*fn)(void*, size_t), void* arg);
+
 // Spawn a subprocess and wait for it to complete.
 // Returns the exit status of the spawned process.
 // Returns -1 if the subprocess did not properly exit.
@@ -823,6 +864,27 @@ struct context {
 
     // Currently loaded/loading modules.
     sbuf(struct module*) modules;
+    // Modules that have been parsed ahead of resolution. Modules remain in
+    // this list after they are loaded.
+    sbuf(struct module*) preparsed;
+    // Index of the loaded/loading modules by canonical path.
+    struct pointer_map module_paths; // interned path => struct module*
+    // Index of the modules parsed ahead of resolution by canonical path.
+    struct pointer_map preparsed_paths; // interned path => struct module*
+
+    // Filesystem queries performed during import resolution, cached for the
+    // duration of the compilation. Boolean queries map to the queried path
+    // when true and to the empty string when false.
+    struct {
+        struct pointer_map search_paths; // "dir\npath" => path or ""
+        struct pointer_map directory_paths; // path => directory path
+        struct pointer_map directory_files; // path => frozen sbuf of files
+        struct pointer_map file_exists; // path => path or ""
+        struct pointer_map file_is_directory; // path => path or ""
+        // Directories of $SUNDER_SEARCH_PATH.
+        sbuf(char const*) search_path_directories;
+        bool search_path_directories_initialized;
+    } import_cache;
 
     // List of symbol tables to be frozen before (successful) program exit.
     //
@@ -934,6 +996,7 @@ enum token_kind {
     TOKEN_PIPE_ASSIGN,         // |=
     TOKEN_CARET_ASSIGN,        // ^=
     TOKEN_AMPERSAND_ASSIGN,    // &=
+    TOKEN_HASH_LBRACKET,       // #[
     TOKEN_SHL,                 // <<
     TOKEN_SHR,                 // >>
     TOKEN_EQ,                  // ==
@@ -1089,6 +1152,15 @@ struct cst_import {
 struct cst_import*
 cst_import_new(struct source_location location, char const* path);
 
+// Function attributes specified by an attribute list preceding a function
+// declaration, e.g. `#[inline, hot]`.
+enum function_attribute {
+    FUNCTION_ATTRIBUTE_INLINE = 1u << 0u,
+    FUNCTION_ATTRIBUTE_NOINLINE = 1u << 1u,
+    FUNCTION_ATTRIBUTE_HOT = 1u << 2u,
+    FUNCTION_ATTRIBUTE_COLD = 1u << 3u,
+};
+
 struct cst_decl {
     struct source_location location;
     char const* name; // interned (from the identifier)
@@ -1125,6 +1197,8 @@ struct cst_decl {
                 function_parameters;
             struct cst_type const* return_type;
             struct cst_block body;
+            // Bitwise-or of zero or more `enum function_attribute` values.
+            unsigned attributes;
         } function;
         struct {
             struct cst_identifier identifier;
@@ -1189,7 +1263,8 @@ cst_decl_new_function(
     struct cst_identifier const* template_parameters,
     struct cst_function_parameter const* const* function_parameters,
     struct cst_type const* return_type,
-    struct cst_block body);
+    struct cst_block body,
+    unsigned attributes);
 struct cst_decl*
 cst_decl_new_struct(
     struct source_location location,
@@ -2143,6 +2218,10 @@ struct symbol_table_element {
 struct symbol_table {
     struct symbol_table const* parent; // optional (NULL => global scope)
     sbuf(struct symbol_table_element) elements;
+    // Index of the most recently inserted symbol for each name. Only built
+    // for tables with enough elements that a linear search is expensive,
+    // such as module tables populated by imports.
+    struct pointer_map index; // interned name => struct symbol const*
 };
 struct symbol_table*
 symbol_table_new(struct symbol_table const* parent);
@@ -2567,6 +2646,12 @@ struct function {
     struct value const* value;
     // True if this function is defined outside of the Sunder sources.
     bool is_extern;
+    // Bitwise-or of zero or more `enum function_attribute` values.
+    unsigned attributes;
+    // True once the body of this function has been resolved. Functions are
+    // completed at the end of the resolve phase of their module, or earlier if
+    // they are called during compile-time evaluation.
+    bool is_complete;
 
     // Outermost symbol table containing symbols for function parameters, local
     // variables, and local constants in the outermost scope (i.e. body) of the
@@ -2701,6 +2786,27 @@ value_gt(struct value const* lhs, struct value const* rhs);
 
 void
 resolve(struct module* module);
+// Source file selected by an import declaration.
+struct import_file {
+    char const* name; // interned
+    char const* path; // interned
+};
+// Append the source files selected by the import of file_name from the module
+// with the provided path to the files list, applying the same search path,
+// directory, and platform-specific file rules used during resolution. Returns
+// NULL on success. Returns the name of the file that could not be found on
+// failure.
+char const*
+resolve_import_files(
+    char const* module_path,
+    char const* file_name,
+    sbuf(struct import_file)* files);
+// Resolve the body of the provided function if it has not yet been resolved.
+// Used by the compile-time evaluator to call functions declared within the
+// module currently being resolved.
+void
+resolve_complete_function(
+    struct source_location location, struct function const* function);
 
 ////////////////////////////////////////////////////////////////////////////////
 //////// eval.c ////////////////////////////////////////////////////////////////
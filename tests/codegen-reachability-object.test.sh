@@ -0,0 +1,94 @@
+# Every function and object outside of a template instance is emitted when
+# compiling an object file with -c, so that they may be referenced by other
+# object files. Template instances are only emitted if they are reachable from
+# those functions and objects. The pointer types of emitted types are also
+# emitted.
+set -e
+
+TMPDIR=$(mktemp -d)
+trap '{ rm -rf -- "${TMPDIR}"; }' EXIT
+cd "${TMPDIR}"
+
+cat >object.sunder <<'END'
+namespace object;
+
+struct node {
+    var value: u32;
+
+    func get(self: *node) u32 {
+        return self.*.value;
+    }
+}
+
+var counter = 0u32;
+let OFFSET = 100u32;
+
+func identity[[T]](value: T) T {
+    return value;
+}
+
+# The instance identity[[u16]] is only referenced at compile-time.
+let IDENTITY_U16_SIZE = sizeof(typeof(identity[[u16]]));
+
+func make_node(value: u32) node {
+    return (:node){.value = identity[[u32]](value)};
+}
+
+func increment() u32 {
+    counter = counter + 1;
+    return counter + OFFSET;
+}
+END
+"${SUNDER_HOME}/bin/sunder-compile" -k -c -o object.o object.sunder
+
+emitted() {
+    if grep -qw "$1" object.o.tmp.c; then
+        echo "emitted $1"
+    else
+        echo "not emitted $1"
+    fi
+}
+emitted object_node
+emitted __sunder_pointer_to_object_node
+emitted object_identity_TEMPLATE_BGN_u32_TEMPLATE_END
+emitted object_identity_TEMPLATE_BGN_u16_TEMPLATE_END
+
+cat >main.c <<'END'
+#include <stdint.h>
+#include <stdio.h>
+
+struct object_node {
+    uint32_t value;
+};
+
+extern uint32_t object_counter;
+extern uint32_t const object_OFFSET;
+extern struct object_node
+object_make_node(uint32_t value);
+extern uint32_t
+object_node_get(struct object_node* self);
+extern uint32_t
+object_increment(void);
+
+int
+main(void)
+{
+    struct object_node node = object_make_node(7);
+    printf("%d\n", (int)object_node_get(&node));
+    printf("%d\n", (int)object_increment());
+    printf("%d\n", (int)object_increment());
+    printf("%d %d\n", (int)object_counter, (int)object_OFFSET);
+    return 0;
+}
+END
+"${SUNDER_CC:-cc}" -o main main.c object.o -lm -lpthread
+./main
+################################################################################
+# emitted object_node
+# emitted __sunder_pointer_to_object_node
+# emitted object_identity_TEMPLATE_BGN_u32_TEMPLATE_END
+# not emitted object_identity_TEMPLATE_BGN_u16_TEMPLATE_END
+# 7
+# 101
+# 102
+# 2 100
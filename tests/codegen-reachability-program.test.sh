@@ -0,0 +1,74 @@
+# Only the functions, objects, and types reachable from `main` are emitted when
+# compiling a program.
+set -e
+
+TMPDIR=$(mktemp -d)
+trap '{ rm -rf -- "${TMPDIR}"; }' EXIT
+cd "${TMPDIR}"
+
+cat >program.sunder <<'END'
+import "std";
+
+struct used_struct {
+    var value: u32;
+}
+
+struct unused_struct {
+    var value: u16;
+}
+
+let USED_CONSTANT = 42u32;
+let UNUSED_CONSTANT = 7u16;
+
+func identity[[T]](value: T) T {
+    return value;
+}
+
+func used() u32 {
+    var s = (:used_struct){.value = identity[[u32]](USED_CONSTANT)};
+    return s.value;
+}
+
+func unused() u16 {
+    var s = (:unused_struct){.value = identity[[u16]](UNUSED_CONSTANT)};
+    return s.value;
+}
+
+func main() void {
+    var value = used();
+    std::print_format_line(
+        std::out(),
+        "{}",
+        (:[]std::formatter)[std::formatter::init[[u32]](&value)]);
+}
+END
+"${SUNDER_HOME}/bin/sunder-compile" -k -o program program.sunder
+./program
+
+emitted() {
+    if grep -qw "$1" program.tmp.c; then
+        echo "emitted $1"
+    else
+        echo "not emitted $1"
+    fi
+}
+emitted main
+emitted used
+emitted used_struct
+emitted USED_CONSTANT
+emitted identity_TEMPLATE_BGN_u32_TEMPLATE_END
+emitted unused
+emitted unused_struct
+emitted UNUSED_CONSTANT
+emitted identity_TEMPLATE_BGN_u16_TEMPLATE_END
+################################################################################
+# 42
+# emitted main
+# emitted used
+# emitted used_struct
+# emitted USED_CONSTANT
+# emitted identity_TEMPLATE_BGN_u32_TEMPLATE_END
+# not emitted unused
+# not emitted unused_struct
+# not emitted UNUSED_CONSTANT
+# not emitted identity_TEMPLATE_BGN_u16_TEMPLATE_END
@@ -0,0 +1,67 @@
+# Call functions of an object file compiled with -c from C, passing and
+# returning aggregates larger than two machine words by value.
+set -e
+
+TMPDIR=$(mktemp -d)
+trap '{ rm -rf -- "${TMPDIR}"; }' EXIT
+cd "${TMPDIR}"
+
+cat >large.sunder <<'END'
+namespace large;
+
+struct quad {
+    var a: u64;
+    var b: u64;
+    var c: u64;
+    var d: u64;
+}
+
+func reversed(q: quad) quad {
+    return (:quad){.a = q.d, .b = q.c, .c = q.b, .d = q.a};
+}
+
+func sum(q: quad, r: quad) u64 {
+    return q.a + q.b + q.c + q.d + r.a + r.b + r.c + r.d;
+}
+
+func reversed_sum(q: quad) u64 {
+    return sum(q, reversed(q));
+}
+END
+"${SUNDER_HOME}/bin/sunder-compile" -c -o large.o large.sunder
+
+cat >main.c <<'END'
+#include <stdint.h>
+#include <stdio.h>
+
+struct large_quad {
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+    uint64_t d;
+};
+
+extern struct large_quad
+large_reversed(struct large_quad q);
+extern uint64_t
+large_sum(struct large_quad q, struct large_quad r);
+extern uint64_t
+large_reversed_sum(struct large_quad q);
+
+int
+main(void)
+{
+    struct large_quad const q = {1, 2, 3, 4};
+    struct large_quad const r = large_reversed(q);
+    printf("%d %d %d %d\n", (int)r.a, (int)r.b, (int)r.c, (int)r.d);
+    printf("%d\n", (int)large_sum(q, r));
+    printf("%d\n", (int)large_reversed_sum(q));
+    return 0;
+}
+END
+"${SUNDER_CC:-cc}" -o main main.c large.o -lm -lpthread
+./main
+################################################################################
+# 4 3 2 1
+# 20
+# 20
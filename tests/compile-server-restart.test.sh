@@ -0,0 +1,86 @@
+# Modify a module loaded by a compile server, checking that the modification
+# is observed by the request following it, that clients connecting while the
+# server restarts are served, and that the server recovers from a module that
+# fails to load.
+set -e
+
+TMPDIR=$(mktemp -d)
+SERVER=
+trap '{ [ -z "${SERVER}" ] || kill "${SERVER}"; rm -rf -- "${TMPDIR}"; }' EXIT
+cd "${TMPDIR}"
+mkdir lib
+export SUNDER_SEARCH_PATH="${SUNDER_SEARCH_PATH}:${TMPDIR}/lib"
+
+greeting() {
+    cat >lib/greeting.sunder <<END
+namespace greeting;
+
+func message() []byte {
+    return "$1";
+}
+END
+}
+
+compile() {
+    "${SUNDER_HOME}/bin/sunder-compile" --connect server.sock -o "$1" main.sunder
+}
+
+greeting before
+printf 'import "std";\nimport "greeting.sunder";\n' >prelude.sunder
+"${SUNDER_HOME}/bin/sunder-compile" --server server.sock prelude.sunder \
+    2>server.log &
+SERVER=$!
+while [ ! -S server.sock ]; do sleep 1; done
+
+cat >main.sunder <<'END'
+import "std";
+import "greeting.sunder";
+
+func main() void {
+    std::print_line(std::out(), greeting::message());
+}
+END
+compile main && ./main
+
+# The request following the modification is served cold, and the server
+# restarts to reload its modules. Requests queued on the socket during the
+# restart are served by the restarted server.
+greeting after
+CLIENTS=
+for i in 1 2 3 4 5 6 7 8; do
+    compile "main${i}" & CLIENTS="${CLIENTS} $!"
+done
+wait ${CLIENTS}
+for i in 1 2 3 4 5 6 7 8; do
+    "./main${i}"
+done
+compile main && ./main
+
+# Requests are served cold while a loaded module fails to load.
+echo 'func message( []byte' >lib/greeting.sunder
+STATUS=0
+compile main || STATUS=$?
+echo "exit status ${STATUS}"
+greeting fixed
+compile main && ./main
+compile main && ./main
+
+kill -0 "${SERVER}" && echo "server running"
+################################################################################
+# before
+# after
+# after
+# after
+# after
+# after
+# after
+# after
+# after
+# after
+# [greeting.sunder:1] error: expected `)`, found `[`
+# func message( []byte
+#               ^
+# exit status 1
+# fixed
+# fixed
+# server running
@@ -0,0 +1,65 @@
+# Compile programs through a compile server, checking that the output and exit
+# status of each request match those of a standalone compilation.
+set -e
+
+TMPDIR=$(mktemp -d)
+SERVER=
+trap '{ [ -z "${SERVER}" ] || kill "${SERVER}"; rm -rf -- "${TMPDIR}"; }' EXIT
+cd "${TMPDIR}"
+
+echo 'import "std";' >prelude.sunder
+"${SUNDER_HOME}/bin/sunder-compile" --server server.sock prelude.sunder \
+    2>server.log &
+SERVER=$!
+while [ ! -S server.sock ]; do sleep 1; done
+
+# Only the owner of the server may connect to it.
+ls -l server.sock | cut -c1-10
+
+cat >hello.sunder <<'END'
+import "std";
+
+func main() void {
+    std::print_line(std::out(), "Hello, world!");
+}
+END
+"${SUNDER_HOME}/bin/sunder-compile" --connect server.sock -o hello hello.sunder
+./hello
+
+# Existing files are not replaced by the socket of a server, whether they are
+# regular files (e.g. from swapped SOCKET and PRELUDE arguments) or the socket
+# of a running server.
+STATUS=0
+"${SUNDER_HOME}/bin/sunder-compile" --server hello.sunder prelude.sunder \
+    || STATUS=$?
+echo "exit status ${STATUS}"
+head -n 1 hello.sunder
+STATUS=0
+"${SUNDER_HOME}/bin/sunder-compile" --server server.sock prelude.sunder \
+    || STATUS=$?
+echo "exit status ${STATUS}"
+"${SUNDER_HOME}/bin/sunder-compile" --connect server.sock -o hello hello.sunder
+./hello
+
+cat >error.sunder <<'END'
+func main() void {
+    foo();
+}
+END
+STATUS=0
+"${SUNDER_HOME}/bin/sunder-compile" --connect server.sock error.sunder \
+    || STATUS=$?
+echo "exit status ${STATUS}"
+################################################################################
+# srw-------
+# Hello, world!
+# error: `hello.sunder` exists and is not a socket
+# exit status 1
+# import "std";
+# error: a server is already listening on `server.sock`
+# exit status 1
+# Hello, world!
+# [error.sunder:2] error: use of undeclared identifier `foo`
+#     foo();
+#     ^
+# exit status 1
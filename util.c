@@ -4,17 +4,19 @@
 #include <errno.h>
 #include <limits.h> /* PATH_MAX */
 #include <inttypes.h>
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <dirent.h> /* DIR, *dir-family */
+#include <pthread.h> /* pthread_* */
 #include <libgen.h> /* dirname */
 #include <sys/stat.h> /* struct stat, stat */
 #include <sys/types.h> /* pid_t */
 #include <sys/wait.h> /* wait* */
-#include <unistd.h> /* execvp, fork, isatty */
+#include <unistd.h> /* execvp, fork, isatty, sysconf */
 
 #include "sunder.h"
 
@@ -171,49 +173,6 @@ xalloc(void* ptr, size_t size)
     return ptr;
 }
 
-// Prepend othr_size bytes from othr onto the xalloc-allocated buffer of size
-// *psize pointed to by *pdata, updating the address of *pdata if necessary.
-static void
-xalloc_prepend(void** pdata, size_t* psize, void const* othr, size_t othr_size)
-{
-    assert(pdata != NULL);
-    assert(psize != NULL);
-    assert(othr != NULL || othr_size == 0);
-    if (othr_size == 0) {
-        // [] + [A][B][C] => [A][B][C]
-        return;
-    }
-
-    size_t const new_size = *psize + othr_size;
-    void* const new_data = xalloc(*pdata, new_size);
-    memmove((char*)new_data + othr_size, new_data, *psize);
-    memcpy(new_data, othr, othr_size);
-
-    *pdata = new_data;
-    *psize = new_size;
-}
-
-// Append othr_size bytes from othr onto the xalloc-allocated buffer of size
-// *psize pointed to by *pdata, updating the address of *pdata if necessary.
-static void
-xalloc_append(void** pdata, size_t* psize, void const* othr, size_t othr_size)
-{
-    assert(pdata != NULL);
-    assert(psize != NULL);
-    assert(othr != NULL || othr_size == 0);
-    if (othr_size == 0) {
-        // [A][B][C] + [] => [A][B][C]
-        return;
-    }
-
-    size_t const new_size = *psize + othr_size;
-    void* const new_data = xalloc(*pdata, new_size);
-    memcpy((char*)new_data + *psize, othr, othr_size);
-
-    *pdata = new_data;
-    *psize = new_size;
-}
-
 char const*
 canonical_path(char const* path)
 {
@@ -501,91 +460,136 @@ struct interned_element {
     uintmax_t hash; // Hash of the string contents.
 };
 
-// Hash set of interned cstrings.
-static sbuf(struct interned_element) interned;
-// Number of in-use elements within the interned hash set.
-static size_t interned_count = 0;
+// The interned string set is split into independently locked shards so that
+// multiple threads (e.g. parsers working on separate modules) may intern
+// strings concurrently. Each string belongs to exactly one shard, selected by
+// hash, so pointer equality of interned strings is preserved.
+#define INTERN__SHARD_COUNT_ ((size_t)16)
+struct interned_shard {
+    pthread_mutex_t mutex;
+    // Hash set of interned cstrings.
+    sbuf(struct interned_element) elements;
+    // Number of in-use elements within the interned hash set.
+    size_t count;
+};
+static struct interned_shard interned[INTERN__SHARD_COUNT_];
+
+// Select a shard using the high bits of a multiplicative mix of the hash.
+// Element slots within a shard are selected by the low bits of the hash, so
+// using the low bits here would leave most slots of each shard unused.
+static struct interned_shard*
+intern__shard_(size_t hash)
+{
+    uint64_t const mixed = (uint64_t)hash * UINT64_C(0x9E3779B97F4A7C15);
+    return &interned[(size_t)(mixed >> 60) % INTERN__SHARD_COUNT_];
+}
 
 void
 intern_init(void)
 {
-    assert(sbuf_count(interned) == 0);
+    for (size_t i = 0; i < INTERN__SHARD_COUNT_; ++i) {
+        struct interned_shard* const shard = &interned[i];
+        assert(sbuf_count(shard->elements) == 0);
 
-    sbuf_resize(interned, 64); // Arbitrary initial count.
-    for (size_t i = 0; i < sbuf_count(interned); ++i) {
-        interned[i] = (struct interned_element){0};
+        if (pthread_mutex_init(&shard->mutex, NULL) != 0) {
+            fatal(NO_LOCATION, "[%s] Failed to initialize mutex", __func__);
+        }
+        sbuf_resize(shard->elements, 64); // Arbitrary initial count.
+        for (size_t j = 0; j < sbuf_count(shard->elements); ++j) {
+            shard->elements[j] = (struct interned_element){0};
+        }
+        shard->count = 0;
     }
 }
 
 void
 intern_fini(void)
 {
-    for (size_t i = 0; i < sbuf_count(interned); ++i) {
-        if (interned[i].string != NULL) {
-            xalloc(interned[i].string, XALLOC_FREE);
+    for (size_t i = 0; i < INTERN__SHARD_COUNT_; ++i) {
+        struct interned_shard* const shard = &interned[i];
+        for (size_t j = 0; j < sbuf_count(shard->elements); ++j) {
+            if (shard->elements[j].string != NULL) {
+                xalloc(shard->elements[j].string, XALLOC_FREE);
+            }
         }
+        sbuf_fini(shard->elements);
+        shard->count = 0;
+        (void)pthread_mutex_destroy(&shard->mutex);
     }
-    sbuf_fini(interned);
 }
 
-char const*
-intern(char const* start, size_t count)
+// Look up or insert a string into a shard. The shard mutex must be held.
+static char const*
+intern__shard_locked_(
+    struct interned_shard* shard, char const* start, size_t count, size_t hash)
 {
-    assert(start != NULL || count == 0);
-    size_t const hash = (size_t)hash_djb2(start, count);
+    sbuf(struct interned_element) elements = shard->elements;
 
     // Check to see if the string has already been interned.
-    for (size_t index = hash % sbuf_count(interned);
-         interned[index].string != NULL;
-         index = (index + 1) % sbuf_count(interned)) {
-        if (interned[index].count != count) {
+    for (size_t index = hash % sbuf_count(elements);
+         elements[index].string != NULL;
+         index = (index + 1) % sbuf_count(elements)) {
+        if (elements[index].count != count) {
             continue;
         }
-        if (safe_memcmp(interned[index].string, start, count) != 0) {
+        if (safe_memcmp(elements[index].string, start, count) != 0) {
             continue;
         }
 
-        return interned[index].string;
+        return elements[index].string;
     }
 
     // Check to see if the set needs resizing.
-    if (2 * (interned_count + 1) > sbuf_count(interned)) {
+    if (2 * (shard->count + 1) > sbuf_count(elements)) {
         // Insert at 50% occupancy. Create a new set with double the existing
         // element count, populate that set with the existing key-value pairs,
         // and then replace the existing set with the new set.
         sbuf(struct interned_element) new = NULL;
-        sbuf_resize(new, sbuf_count(interned) * 2);
+        sbuf_resize(new, sbuf_count(elements) * 2);
         for (size_t i = 0; i < sbuf_count(new); ++i) {
             new[i] = (struct interned_element){0};
         }
 
-        for (size_t i = 0; i < sbuf_count(interned); ++i) {
-            if (interned[i].string == NULL) {
+        for (size_t i = 0; i < sbuf_count(elements); ++i) {
+            if (elements[i].string == NULL) {
                 continue;
             }
 
-            size_t index = (size_t)interned[i].hash % sbuf_count(new);
+            size_t index = (size_t)elements[i].hash % sbuf_count(new);
             while (new[index].string != NULL) {
                 index = (index + 1) % sbuf_count(new);
             }
-            new[index] = interned[i];
+            new[index] = elements[i];
         }
 
-        sbuf_fini(interned);
-        interned = new;
+        sbuf_fini(elements);
+        shard->elements = elements = new;
     }
 
     // Insert into the set.
-    size_t index = hash % sbuf_count(interned);
-    while (interned[index].string != NULL) {
-        index = (index + 1) % sbuf_count(interned);
+    size_t index = hash % sbuf_count(elements);
+    while (elements[index].string != NULL) {
+        index = (index + 1) % sbuf_count(elements);
     }
     char* str = cstr_new(start, count);
-    interned[index] = (struct interned_element){str, count, hash};
-    interned_count += 1;
+    elements[index] = (struct interned_element){str, count, hash};
+    shard->count += 1;
     return str;
 }
 
+char const*
+intern(char const* start, size_t count)
+{
+    assert(start != NULL || count == 0);
+    size_t const hash = (size_t)hash_djb2(start, count);
+
+    struct interned_shard* const shard = intern__shard_(hash);
+    (void)pthread_mutex_lock(&shard->mutex);
+    char const* const result = intern__shard_locked_(shard, start, count, hash);
+    (void)pthread_mutex_unlock(&shard->mutex);
+    return result;
+}
+
 char const*
 intern_cstr(char const* cstr)
 {
@@ -663,6 +667,83 @@ sbuf__grw_(size_t elemsize, void* sbuf)
     return sbuf__rsv_(elemsize, sbuf, new_cap);
 }
 
+static size_t
+pointer_map__index_(struct pointer_map const* map, void const* key)
+{
+    assert(map != NULL);
+    assert(key != NULL);
+
+    size_t index = (size_t)hash(&key, sizeof(key)) % sbuf_count(map->elements);
+    while (map->elements[index].key != NULL
+           && map->elements[index].key != key) {
+        index = (index + 1) % sbuf_count(map->elements);
+    }
+    return index;
+}
+
+void const*
+pointer_map_lookup(struct pointer_map const* map, void const* key)
+{
+    assert(map != NULL);
+
+    if (sbuf_count(map->elements) == 0) {
+        return NULL;
+    }
+    return map->elements[pointer_map__index_(map, key)].val;
+}
+
+bool
+pointer_map_insert(struct pointer_map* map, void const* key, void const* val)
+{
+    assert(map != NULL);
+    assert(key != NULL);
+    assert(val != NULL);
+
+    if (2 * (map->count + 1) > sbuf_count(map->elements)) {
+        // Resize at 50% occupancy.
+        sbuf(struct pointer_map_element) const old = map->elements;
+        size_t const capacity = sbuf_count(old) == 0 ? 64 : sbuf_count(old) * 2;
+        map->elements = NULL;
+        sbuf_resize(map->elements, capacity);
+        for (size_t i = 0; i < sbuf_count(map->elements); ++i) {
+            map->elements[i] = (struct pointer_map_element){0};
+        }
+        for (size_t i = 0; i < sbuf_count(old); ++i) {
+            if (old[i].key != NULL) {
+                map->elements[pointer_map__index_(map, old[i].key)] = old[i];
+            }
+        }
+        sbuf_fini(old);
+    }
+
+    size_t const index = pointer_map__index_(map, key);
+    if (map->elements[index].key != NULL) {
+        return false;
+    }
+    map->elements[index] = (struct pointer_map_element){key, val};
+    map->count += 1;
+    return true;
+}
+
+void
+pointer_map_assign(struct pointer_map* map, void const* key, void const* val)
+{
+    assert(map != NULL);
+
+    if (!pointer_map_insert(map, key, val)) {
+        map->elements[pointer_map__index_(map, key)].val = val;
+    }
+}
+
+void
+pointer_map_fini(struct pointer_map* map)
+{
+    assert(map != NULL);
+
+    sbuf_fini(map->elements);
+    *map = (struct pointer_map){0};
+}
+
 #define BITARR__WORD_TYPE_ unsigned long
 #define BITARR__WORD_SIZE_ sizeof(BITARR__WORD_TYPE_)
 #define BITARR__WORD_BITS_ (BITARR__WORD_SIZE_ * CHAR_BIT)
@@ -1004,9 +1085,9 @@ struct bigint {
     // +1 if the integer >  0
     int sign;
     // Magnitude of the integer.
-    // Little endian list of bytes.
+    // Little endian list of limbs.
     // The integer zero will have limbs == NULL.
-    uint8_t* limbs;
+    uint32_t* limbs;
     // Number of limbs.
     // The integer zero will have count == 0.
     size_t count;
@@ -1015,32 +1096,29 @@ struct bigint {
 // the natural word size of the target machine. For instance the GMP mp_limb_t
 // type is a typedef of either unsigned int, unsigned long int, or unsigned
 // long long int depending on configuration options and the host environment.
-// This arbitrary precision integer implementation uses eight-bit limbs to
-// avoid configuration options, preprocessor checks, and/or bugs that would
-// come about from having multiple potential limb sizes. On every (modern)
-// machine uint8_t and uint16_t values will implicitly cast up to unsigned int
-// values cleanly which makes addition and multiplication of limbs work without
-// needing to think too hard.
-#define BIGINT__LIMB_BITS_ ((size_t)8)
+// This arbitrary precision integer implementation uses 32-bit limbs on every
+// host so that the product of two limbs (plus a carry) always fits within a
+// uint64_t intermediate, which is guaranteed to exist in C99, avoiding
+// configuration options and preprocessor checks for 128-bit integer support.
+#define BIGINT__LIMB_BITS_ ((size_t)32)
+#define BIGINT__LIMB_SIZE_ sizeof(uint32_t)
+#define BIGINT__LIMB_BASE_ ((uint64_t)1 << BIGINT__LIMB_BITS_)
 STATIC_ASSERT(
     correct_bits_per_limb,
     BIGINT__LIMB_BITS_ == (sizeof(*((struct bigint*)0)->limbs) * CHAR_BIT));
 
+// Largest power of ten that fits within a single limb, and the number of
+// decimal digits it spans. Decimal conversion operates on chunks of this many
+// digits at a time rather than on individual digits.
+#define BIGINT__DEC_CHUNK_ ((uint32_t)1000000000u)
+#define BIGINT__DEC_CHUNK_DIGITS_ ((size_t)9)
+
 struct bigint const* const BIGINT_ZERO =
     &(struct bigint){.sign = 0, .limbs = NULL, .count = 0u};
 struct bigint const* const BIGINT_POS_ONE =
-    &(struct bigint){.sign = +1, .limbs = (uint8_t[]){0x01}, .count = 1u};
+    &(struct bigint){.sign = +1, .limbs = (uint32_t[]){0x01}, .count = 1u};
 struct bigint const* const BIGINT_NEG_ONE =
-    &(struct bigint){.sign = -1, .limbs = (uint8_t[]){0x01}, .count = 1u};
-
-static struct bigint const* const BIGINT_DEC =
-    &(struct bigint){.sign = +1, .limbs = (uint8_t[]){0x0A}, .count = 1u};
-static struct bigint const* const BIGINT_BIN =
-    &(struct bigint){.sign = +1, .limbs = (uint8_t[]){0x02}, .count = 1u};
-static struct bigint const* const BIGINT_OCT =
-    &(struct bigint){.sign = +1, .limbs = (uint8_t[]){0x08}, .count = 1u};
-static struct bigint const* const BIGINT_HEX =
-    &(struct bigint){.sign = +1, .limbs = (uint8_t[]){0x10}, .count = 1u};
+    &(struct bigint){.sign = -1, .limbs = (uint32_t[]){0x01}, .count = 1u};
 
 static void
 bigint__fini_(struct bigint* self)
@@ -1063,8 +1141,9 @@ bigint__resize_(struct bigint* self, size_t count)
 
     size_t const nlimbs = count - self->count; // Number of limbs to add.
     self->count = count;
-    self->limbs = xalloc(self->limbs, self->count);
-    memset(self->limbs + self->count - nlimbs, 0x00, nlimbs);
+    self->limbs = xalloc(self->limbs, self->count * BIGINT__LIMB_SIZE_);
+    memset(
+        self->limbs + self->count - nlimbs, 0x00, nlimbs * BIGINT__LIMB_SIZE_);
 }
 
 static void
@@ -1092,9 +1171,12 @@ bigint__shiftl_limbs_(struct bigint* self, size_t nlimbs)
     }
 
     self->count += nlimbs;
-    self->limbs = xalloc(self->limbs, self->count);
-    memmove((char*)self->limbs + nlimbs, self->limbs, self->count - nlimbs);
-    memset(self->limbs, 0x00, nlimbs);
+    self->limbs = xalloc(self->limbs, self->count * BIGINT__LIMB_SIZE_);
+    memmove(
+        self->limbs + nlimbs,
+        self->limbs,
+        (self->count - nlimbs) * BIGINT__LIMB_SIZE_);
+    memset(self->limbs, 0x00, nlimbs * BIGINT__LIMB_SIZE_);
 }
 
 // Shift right by nlimbs number of limbs.
@@ -1116,11 +1198,72 @@ bigint__shiftr_limbs_(struct bigint* self, size_t nlimbs)
             self->count);
     }
 
-    memmove((char*)self->limbs, self->limbs + nlimbs, self->count - nlimbs);
+    memmove(
+        self->limbs,
+        self->limbs + nlimbs,
+        (self->count - nlimbs) * BIGINT__LIMB_SIZE_);
     self->count -= nlimbs;
     bigint__normalize_(self);
 }
 
+// Assign the magnitude of self to the provided uintmax_t value, leaving the
+// sign of self as +1 (or 0 if the value is zero).
+static void
+bigint__assign_umax_(struct bigint* self, uintmax_t umax)
+{
+    assert(self != NULL);
+
+    bigint__resize_(self, 0);
+    while (umax != 0) {
+        bigint__resize_(self, self->count + 1);
+        self->limbs[self->count - 1] = (uint32_t)umax;
+        // Two shifts by half a limb avoid an undefined full-width shift when
+        // uintmax_t is no wider than a single limb.
+        umax = (umax >> (BIGINT__LIMB_BITS_ / 2)) >> (BIGINT__LIMB_BITS_ / 2);
+    }
+    self->sign = self->count != 0;
+}
+
+// self = self * mul + add, treating self as a non-negative magnitude.
+static void
+bigint__mul_add_small_(struct bigint* self, uint32_t mul, uint32_t add)
+{
+    assert(self != NULL);
+
+    uint64_t carry = add;
+    for (size_t i = 0; i < self->count; ++i) {
+        uint64_t const t = (uint64_t)self->limbs[i] * mul + carry;
+        self->limbs[i] = (uint32_t)t;
+        carry = t >> BIGINT__LIMB_BITS_;
+    }
+    if (carry != 0) {
+        bigint__resize_(self, self->count + 1);
+        self->limbs[self->count - 1] = (uint32_t)carry;
+    }
+    bigint__normalize_(self);
+    if (self->count != 0 && self->sign == 0) {
+        self->sign = +1;
+    }
+}
+
+// self = self / div, treating self as a non-negative magnitude.
+// Returns the remainder.
+static uint32_t
+bigint__divrem_small_(struct bigint* self, uint32_t div)
+{
+    assert(self != NULL);
+    assert(div != 0);
+
+    uint64_t rem = 0;
+    for (size_t i = self->count; i--;) {
+        uint64_t const cur = (rem << BIGINT__LIMB_BITS_) | self->limbs[i];
+        self->limbs[i] = (uint32_t)(cur / div);
+        rem = cur % div;
+    }
+    bigint__normalize_(self);
+    return (uint32_t)rem;
+}
+
 struct bigint*
 bigint_new(struct bigint const* othr)
 {
@@ -1135,23 +1278,22 @@ bigint_new(struct bigint const* othr)
 struct bigint*
 bigint_new_umax(uintmax_t umax)
 {
-    char buf[255] = {0};
-    int const written = snprintf(buf, sizeof(buf), "%ju", umax);
-    assert(written >= 0 && written < (int)sizeof(buf));
-    (void)written;
-
-    return bigint_new_text(buf, strlen(buf));
+    struct bigint* const self = bigint_new(BIGINT_ZERO);
+    bigint__assign_umax_(self, umax);
+    return self;
 }
 
 struct bigint*
 bigint_new_smax(intmax_t smax)
 {
-    char buf[255] = {0};
-    int const written = snprintf(buf, sizeof(buf), "%jd", smax);
-    assert(written >= 0 && written < (int)sizeof(buf));
-    (void)written;
-
-    return bigint_new_text(buf, strlen(buf));
+    // Negate in the unsigned domain so that INTMAX_MIN is handled correctly.
+    uintmax_t const magnitude =
+        smax < 0 ? (uintmax_t)0 - (uintmax_t)smax : (uintmax_t)smax;
+    struct bigint* const self = bigint_new_umax(magnitude);
+    if (smax < 0) {
+        self->sign = -1;
+    }
+    return self;
 }
 
 struct bigint*
@@ -1182,7 +1324,6 @@ bigint_new_text(char const* start, size_t count)
 
     // Default to decimal radix.
     int radix = 10;
-    struct bigint const* radix_bigint = BIGINT_DEC;
     int (*radix_isdigit)(int c) = safe_isdigit;
 
     // Begin iterating over the string from left to right.
@@ -1217,21 +1358,18 @@ radix:
 
     if (cur[1] == 'b') {
         radix = 2;
-        radix_bigint = BIGINT_BIN;
         radix_isdigit = safe_isbdigit;
         cur += 2;
         goto digits;
     }
     if (cur[1] == 'o') {
         radix = 8;
-        radix_bigint = BIGINT_OCT;
         radix_isdigit = safe_isodigit;
         cur += 2;
         goto digits;
     }
     if (cur[1] == 'x') {
         radix = 16;
-        radix_bigint = BIGINT_HEX;
         radix_isdigit = safe_isxdigit;
         cur += 2;
         goto digits;
@@ -1251,22 +1389,24 @@ digits:
         cur += 1;
     }
 
+    // Accumulate digits into a single limb-sized chunk, and fold each chunk
+    // into the result with one multiply-add pass over the limbs. The chunk
+    // multiplier radix^n is kept below 2^32 for every supported radix.
     self = bigint_new(BIGINT_ZERO);
     cur = digits_start;
     while (cur != end) {
-        errno = 0;
-        uint8_t const digit_value =
-            (uint8_t)strtol((char[]){(char)*cur, '\0'}, NULL, radix);
-        if (errno != 0) {
-            goto error;
+        uint32_t chunk = 0;
+        uint32_t chunk_mul = 1;
+        while (cur != end && chunk_mul <= UINT32_MAX / (uint32_t)radix) {
+            int const c = *cur;
+            uint32_t const digit_value = safe_isdigit(c)
+                ? (uint32_t)(c - '0')
+                : (uint32_t)(safe_tolower(c) - 'a' + 10);
+            chunk = chunk * (uint32_t)radix + digit_value;
+            chunk_mul *= (uint32_t)radix;
+            cur += 1;
         }
-
-        struct bigint const digit_bigint = {
-            .sign = +1, .limbs = (uint8_t[]){digit_value}, .count = 1u};
-        bigint_mul(self, self, radix_bigint);
-        bigint_add(self, self, &digit_bigint);
-
-        cur += 1;
+        bigint__mul_add_small_(self, chunk_mul, chunk);
     }
 
     self->sign = sign;
@@ -1298,6 +1438,24 @@ bigint_freeze(struct bigint* self)
     freeze(self->limbs);
 }
 
+// Compare the magnitudes of lhs and rhs, ignoring sign.
+static int
+bigint__magnitude_cmp_(struct bigint const* lhs, struct bigint const* rhs)
+{
+    assert(lhs != NULL);
+    assert(rhs != NULL);
+
+    if (lhs->count != rhs->count) {
+        return lhs->count > rhs->count ? +1 : -1;
+    }
+    for (size_t i = lhs->count; i--;) {
+        if (lhs->limbs[i] != rhs->limbs[i]) {
+            return lhs->limbs[i] > rhs->limbs[i] ? +1 : -1;
+        }
+    }
+    return 0;
+}
+
 int
 bigint_cmp(struct bigint const* lhs, struct bigint const* rhs)
 {
@@ -1312,30 +1470,7 @@ bigint_cmp(struct bigint const* lhs, struct bigint const* rhs)
     }
 
     assert(lhs->sign == rhs->sign);
-    int const sign = lhs->sign;
-    if (lhs->count > rhs->count) {
-        return sign;
-    }
-    if (lhs->count < rhs->count) {
-        return -sign;
-    }
-
-    assert(lhs->count == rhs->count);
-    size_t const count = lhs->count;
-    for (size_t i = 0; i < count; ++i) {
-        size_t limb_idx = count - i - 1;
-        uint8_t const lhs_limb = lhs->limbs[limb_idx];
-        uint8_t const rhs_limb = rhs->limbs[limb_idx];
-
-        if (lhs_limb > rhs_limb) {
-            return sign;
-        }
-        if (lhs_limb < rhs_limb) {
-            return -sign;
-        }
-    }
-
-    return 0;
+    return lhs->sign * bigint__magnitude_cmp_(lhs, rhs);
 }
 
 void
@@ -1348,12 +1483,12 @@ bigint_assign(struct bigint* self, struct bigint const* othr)
     }
 
     self->sign = othr->sign;
-    self->limbs = xalloc(self->limbs, othr->count);
+    self->limbs = xalloc(self->limbs, othr->count * BIGINT__LIMB_SIZE_);
     self->count = othr->count;
     if (self->sign != 0) {
         assert(self->limbs != NULL);
         assert(othr->limbs != NULL);
-        memcpy(self->limbs, othr->limbs, othr->count);
+        memcpy(self->limbs, othr->limbs, othr->count * BIGINT__LIMB_SIZE_);
     }
 }
 
@@ -1424,18 +1559,18 @@ bigint_add(
     int const sign = lhs->sign;
 
     struct bigint RES = {0};
+    bigint__resize_(
+        &RES, 1 + (lhs->count > rhs->count ? lhs->count : rhs->count));
     RES.sign = sign;
-    RES.count = 1 + (lhs->count > rhs->count ? lhs->count : rhs->count);
-    RES.limbs = xalloc(RES.limbs, RES.count);
 
-    unsigned carry = 0;
+    uint64_t carry = 0;
     for (size_t i = 0; i < RES.count; ++i) {
-        unsigned const lhs_limb = i < lhs->count ? lhs->limbs[i] : 0; // upcast
-        unsigned const rhs_limb = i < rhs->count ? rhs->limbs[i] : 0; // upcast
-        unsigned const tot = lhs_limb + rhs_limb + carry;
+        uint64_t const lhs_limb = i < lhs->count ? lhs->limbs[i] : 0; // upcast
+        uint64_t const rhs_limb = i < rhs->count ? rhs->limbs[i] : 0; // upcast
+        uint64_t const tot = lhs_limb + rhs_limb + carry;
 
-        RES.limbs[i] = (uint8_t)tot;
-        carry = tot > UINT8_MAX;
+        RES.limbs[i] = (uint32_t)tot;
+        carry = tot >> BIGINT__LIMB_BITS_;
     }
     assert(carry == 0);
 
@@ -1498,18 +1633,17 @@ bigint_sub(
     }
 
     struct bigint RES = {0};
+    bigint__resize_(&RES, lhs->count > rhs->count ? lhs->count : rhs->count);
     RES.sign = lhs->sign;
-    RES.count = lhs->count > rhs->count ? lhs->count : rhs->count;
-    RES.limbs = xalloc(RES.limbs, RES.count);
 
-    unsigned borrow = 0;
+    uint64_t borrow = 0;
     for (size_t i = 0; i < RES.count; ++i) {
-        unsigned const lhs_limb = i < lhs->count ? lhs->limbs[i] : 0; // upcast
-        unsigned const rhs_limb = i < rhs->count ? rhs->limbs[i] : 0; // upcast
-        unsigned const tot = (lhs_limb - rhs_limb) - borrow;
+        uint64_t const lhs_limb = i < lhs->count ? lhs->limbs[i] : 0; // upcast
+        uint64_t const rhs_limb = i < rhs->count ? rhs->limbs[i] : 0; // upcast
+        uint64_t const tot = (lhs_limb - rhs_limb) - borrow;
 
-        RES.limbs[i] = (uint8_t)tot;
-        borrow = tot > UINT8_MAX;
+        RES.limbs[i] = (uint32_t)tot;
+        borrow = tot >> 63; // Set if the subtraction wrapped.
     }
     assert(borrow == 0);
 
@@ -1547,35 +1681,25 @@ bigint_mul(
     size_t const count = lhs->count + rhs->count;
     struct bigint W = {0}; // abs(res)
     bigint__resize_(&W, count);
-    uint8_t* const w = W.limbs;
-    uint8_t const* const u = lhs->limbs;
-    uint8_t const* const v = rhs->limbs;
+    uint32_t* const w = W.limbs;
+    uint32_t const* const u = lhs->limbs;
+    uint32_t const* const v = rhs->limbs;
     size_t const m = lhs->count;
     size_t const n = rhs->count;
-    static unsigned const b = UINT8_MAX + 1;
     for (size_t j = 0; j < n; ++j) {
         if (v[j] == 0) {
             w[j + m] = 0;
             continue;
         }
-        unsigned k = 0;
+        // The maximum value of t is (b-1)*(b-1) + (b-1) + (b-1) == b*b - 1,
+        // which fits within a uint64_t for b == 2^32.
+        uint64_t k = 0;
         for (size_t i = 0; i < m; ++i) {
-            unsigned u_limb = 0;
-            if (i < lhs->count) {
-                u_limb = u[i];
-            }
-
-            unsigned v_limb = 0;
-            if (j < rhs->count) {
-                v_limb = v[j];
-            }
-
-            unsigned const t = (unsigned)(u_limb * v_limb) + w[i + j] + k;
-            w[i + j] = (uint8_t)(t % b);
-            k = t / b;
-            assert(k <= b && "k will always be in the range 0 <= k < b");
+            uint64_t const t = (uint64_t)u[i] * v[j] + w[i + j] + k;
+            w[i + j] = (uint32_t)t;
+            k = t >> BIGINT__LIMB_BITS_;
         }
-        w[j + m] = (uint8_t)k;
+        w[j + m] = (uint32_t)k;
     }
 
     W.sign = lhs->sign * rhs->sign;
@@ -1584,6 +1708,117 @@ bigint_mul(
     bigint__fini_(&W);
 }
 
+// Returns the number of leading zero bits in a non-zero limb.
+static unsigned
+bigint__limb_nlz_(uint32_t limb)
+{
+    assert(limb != 0);
+
+    unsigned n = 0;
+    while ((limb & 0x80000000u) == 0) {
+        limb <<= 1u;
+        n += 1;
+    }
+    return n;
+}
+
+// Divide the magnitude N by the magnitude D, where D has at least two limbs
+// and N has at least as many limbs as D, storing the quotient magnitude in Q
+// and the remainder magnitude in R.
+//
+// Algorithm D (Division of Nonnegative Integers)
+// Source: Art of Computer Programming, Volume 2: Seminumerical Algorithms
+//         (Third Edition) page. 272.
+static void
+bigint__divrem_knuth_(
+    struct bigint* Q,
+    struct bigint* R,
+    struct bigint const* N,
+    struct bigint const* D)
+{
+    size_t const n = D->count;
+    size_t const m = N->count - n;
+    assert(n >= 2);
+    assert(N->count >= n);
+
+    // D1. [Normalize.] Shift so that the top limb of the divisor has its high
+    // bit set, which bounds the error of each quotient limb estimate.
+    unsigned const s = bigint__limb_nlz_(D->limbs[n - 1]);
+    uint32_t* const vn = xalloc(NULL, n * BIGINT__LIMB_SIZE_);
+    uint32_t* const un = xalloc(NULL, (N->count + 1) * BIGINT__LIMB_SIZE_);
+    for (size_t i = n - 1; i > 0; --i) {
+        vn[i] = (uint32_t)(((uint64_t)D->limbs[i] << s)
+                           | ((uint64_t)D->limbs[i - 1] >> (32u - s)));
+    }
+    vn[0] = (uint32_t)((uint64_t)D->limbs[0] << s);
+    un[N->count] = (uint32_t)((uint64_t)N->limbs[N->count - 1] >> (32u - s));
+    for (size_t i = N->count - 1; i > 0; --i) {
+        un[i] = (uint32_t)(((uint64_t)N->limbs[i] << s)
+                           | ((uint64_t)N->limbs[i - 1] >> (32u - s)));
+    }
+    un[0] = (uint32_t)((uint64_t)N->limbs[0] << s);
+
+    bigint__resize_(Q, 0);
+    bigint__resize_(Q, m + 1);
+    for (size_t j = m + 1; j--;) {
+        // D3. [Calculate q̂.]
+        uint64_t const num = ((uint64_t)un[j + n] << BIGINT__LIMB_BITS_)
+            | un[j + n - 1];
+        uint64_t qhat = num / vn[n - 1];
+        uint64_t rhat = num % vn[n - 1];
+        while (qhat >= BIGINT__LIMB_BASE_
+               || qhat * vn[n - 2]
+                   > ((rhat << BIGINT__LIMB_BITS_) | un[j + n - 2])) {
+            qhat -= 1;
+            rhat += vn[n - 1];
+            if (rhat >= BIGINT__LIMB_BASE_) {
+                break;
+            }
+        }
+
+        // D4. [Multiply and subtract.]
+        uint64_t carry = 0;
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t const p = qhat * vn[i] + carry;
+            carry = p >> BIGINT__LIMB_BITS_;
+            uint64_t const t = (uint64_t)un[i + j] - (uint32_t)p - borrow;
+            un[i + j] = (uint32_t)t;
+            borrow = t >> 63;
+        }
+        uint64_t const t = (uint64_t)un[j + n] - carry - borrow;
+        un[j + n] = (uint32_t)t;
+
+        // D5. [Test remainder.] D6. [Add back.]
+        if (t >> 63) {
+            qhat -= 1;
+            uint64_t k = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t const sum = (uint64_t)un[i + j] + vn[i] + k;
+                un[i + j] = (uint32_t)sum;
+                k = sum >> BIGINT__LIMB_BITS_;
+            }
+            un[j + n] = (uint32_t)((uint64_t)un[j + n] + k);
+        }
+        Q->limbs[j] = (uint32_t)qhat;
+    }
+    Q->sign = +1;
+    bigint__normalize_(Q);
+
+    // D8. [Unnormalize.]
+    bigint__resize_(R, 0);
+    bigint__resize_(R, n);
+    for (size_t i = 0; i < n; ++i) {
+        R->limbs[i] = (uint32_t)(((uint64_t)un[i] >> s)
+                                 | ((uint64_t)un[i + 1] << (32u - s)));
+    }
+    R->sign = +1;
+    bigint__normalize_(R);
+
+    xalloc(vn, XALLOC_FREE);
+    xalloc(un, XALLOC_FREE);
+}
+
 void
 bigint_divrem(
     struct bigint* res,
@@ -1599,39 +1834,23 @@ bigint_divrem(
         fatal(NO_LOCATION, "[%s] Divide by zero", __func__);
     }
 
-    // Binary Long Division Algorithm
-    // Source: https://en.wikipedia.org/wiki/Division_algorithm#Long_division
-    //
-    // The following algorithm, the binary version of the famous long division,
-    // will divide N by D, placing the quotient in Q and the remainder in R. In
-    // the following code, all values are treated as unsigned integers.
-    //
-    // if D = 0 then error(DivisionByZeroException) end
-    // Q := 0                  -- Initialize quotient and remainder to zero
-    // R := 0
-    // for i := n − 1 .. 0 do  -- Where n is number of bits in N
-    //   R := R << 1           -- Left-shift R by 1 bit
-    //   R(0) := N(i)          -- Set the least-significant bit of R equal to
-    //                            bit i of the numerator
-    //   if R ≥ D then
-    //     R := R − D
-    //     Q(i) := 1
-    //   end
-    // end
     struct bigint Q = {0}; // abs(res)
     struct bigint R = {0}; // abs(rem)
     struct bigint N = {0}; // abs(lhs)
     bigint_abs(&N, lhs);
     struct bigint D = {0}; // abs(rhs)
     bigint_abs(&D, rhs);
-    size_t const n = bigint_magnitude_bit_count(lhs);
-    for (size_t i = n - 1; i < n; --i) {
-        bigint_magnitude_shiftl(&R, 1);
-        bigint_magnitude_bit_set(&R, 0, bigint_magnitude_bit_get(&N, i));
-        if (bigint_cmp(&R, &D) >= 0) {
-            bigint_sub(&R, &R, &D);
-            bigint_magnitude_bit_set(&Q, i, 1);
-        }
+    if (bigint__magnitude_cmp_(&N, &D) < 0) {
+        // |lhs| < |rhs| => quotient is zero and remainder is lhs.
+        bigint_assign(&R, &N);
+    }
+    else if (D.count == 1) {
+        bigint_assign(&Q, &N);
+        uint32_t const r = bigint__divrem_small_(&Q, D.limbs[0]);
+        bigint__assign_umax_(&R, r);
+    }
+    else {
+        bigint__divrem_knuth_(&Q, &R, &N, &D);
     }
 
     // printf("%2d %2d\n", +7 / +3, +7 % +3); // 2  1
@@ -1671,21 +1890,19 @@ bigint_magnitude_shiftl(struct bigint* self, size_t nbits)
     }
 
     bigint__shiftl_limbs_(self, nbits / BIGINT__LIMB_BITS_);
-    for (size_t n = 0; n < nbits % BIGINT__LIMB_BITS_; ++n) {
-        if (self->limbs[self->count - 1] & 0x80) {
-            self->count += 1;
-            self->limbs = xalloc(self->limbs, self->count);
-            self->limbs[self->count - 1] = 0x00;
-        }
-        // [limb0 << 1][limb1 << 1 | msbit(limb0)][limb2 << 1 | msbit(limb1)]...
-        for (size_t i = self->count - 1; i > 0; --i) {
-            self->limbs[i] = (uint8_t)(self->limbs[i] << 1u);
-            if (self->limbs[i - 1] & 0x80) {
-                self->limbs[i] |= 0x01;
-            }
-        }
-        self->limbs[0] = (uint8_t)(self->limbs[0] << 1u);
+    unsigned const shift = (unsigned)(nbits % BIGINT__LIMB_BITS_);
+    if (shift == 0) {
+        return;
+    }
+
+    // [limb0 << s][limb1 << s | limb0 >> (32-s)]...
+    bigint__resize_(self, self->count + 1);
+    for (size_t i = self->count - 1; i > 0; --i) {
+        self->limbs[i] = (uint32_t)(((uint64_t)self->limbs[i] << shift)
+                                    | (self->limbs[i - 1] >> (32u - shift)));
     }
+    self->limbs[0] = (uint32_t)((uint64_t)self->limbs[0] << shift);
+    bigint__normalize_(self);
 }
 
 void
@@ -1702,17 +1919,18 @@ bigint_magnitude_shiftr(struct bigint* self, size_t nbits)
     }
 
     bigint__shiftr_limbs_(self, nbits / BIGINT__LIMB_BITS_);
-    for (size_t n = 0; n < nbits % BIGINT__LIMB_BITS_; ++n) {
-        // [limb0 >> 1 | lsbit(limb1)][limb1 >> 1 | lsbit(limb2)]...
-        for (size_t i = 0; i < self->count - 1; ++i) {
-            self->limbs[i] = (uint8_t)(self->limbs[i] >> 1u);
-            if (self->limbs[i + 1] & 0x01) {
-                self->limbs[i] |= 0x80;
-            }
-        }
-        self->limbs[self->count - 1] =
-            (uint8_t)(self->limbs[self->count - 1] >> 1u);
+    unsigned const shift = (unsigned)(nbits % BIGINT__LIMB_BITS_);
+    if (shift == 0) {
+        return;
     }
+
+    // [limb0 >> s | limb1 << (32-s)][limb1 >> s | limb2 << (32-s)]...
+    for (size_t i = 0; i < self->count - 1; ++i) {
+        self->limbs[i] = (uint32_t)((self->limbs[i] >> shift)
+                                    | ((uint64_t)self->limbs[i + 1]
+                                       << (32u - shift)));
+    }
+    self->limbs[self->count - 1] = self->limbs[self->count - 1] >> shift;
     bigint__normalize_(self);
 }
 
@@ -1725,12 +1943,8 @@ bigint_magnitude_bit_count(struct bigint const* self)
         return 0;
     }
 
-    uint8_t top = self->limbs[self->count - 1];
-    size_t top_bit_count = 0;
-    while (top != 0) {
-        top_bit_count += 1;
-        top = top >> 1;
-    }
+    uint32_t const top = self->limbs[self->count - 1];
+    size_t const top_bit_count = BIGINT__LIMB_BITS_ - bigint__limb_nlz_(top);
     return (self->count - 1) * BIGINT__LIMB_BITS_ + top_bit_count;
 }
 
@@ -1743,8 +1957,8 @@ bigint_magnitude_bit_get(struct bigint const* self, size_t n)
         return 0;
     }
 
-    uint8_t const limb = self->limbs[n / BIGINT__LIMB_BITS_];
-    uint8_t const mask = (uint8_t)(1u << (n % BIGINT__LIMB_BITS_));
+    uint32_t const limb = self->limbs[n / BIGINT__LIMB_BITS_];
+    uint32_t const mask = (uint32_t)1u << (n % BIGINT__LIMB_BITS_);
     return (limb & mask) != 0;
 }
 
@@ -1765,9 +1979,9 @@ bigint_magnitude_bit_set(struct bigint* self, size_t n, int value)
         bigint__resize_(self, limb_idx + 1);
     }
 
-    uint8_t* const plimb = self->limbs + limb_idx;
-    uint8_t const mask = (uint8_t)(1 << (n % BIGINT__LIMB_BITS_));
-    *plimb = (uint8_t)(value ? *plimb | mask : *plimb & ~mask);
+    uint32_t* const plimb = self->limbs + limb_idx;
+    uint32_t const mask = (uint32_t)1u << (n % BIGINT__LIMB_BITS_);
+    *plimb = value ? *plimb | mask : *plimb & ~mask;
     if (self->sign == 0 && value) {
         // If the integer was zero (i.e. had sign zero) before and a bit was
         // just flipped "on" then treat that integer as it if turned from the
@@ -1813,20 +2027,21 @@ bigint_to_umax(uintmax_t* res, struct bigint const* bigint)
     assert(res != NULL);
     assert(bigint != NULL);
 
-    if (bigint_cmp(bigint, BIGINT_ZERO) < 0) {
+    if (bigint->sign < 0) {
         return -1;
     }
-
-    char* const cstr = bigint_to_new_cstr(bigint);
-    errno = 0;
-    uintmax_t umax = strtoumax(cstr, NULL, 0);
-    int const err = errno; // save errno
-    xalloc(cstr, XALLOC_FREE);
-    assert(err == 0 || err == ERANGE);
-    if (err == ERANGE) {
+    if (bigint_magnitude_bit_count(bigint) > sizeof(uintmax_t) * CHAR_BIT) {
         return -1;
     }
 
+    uintmax_t umax = 0;
+    for (size_t i = bigint->count; i--;) {
+        // Two shifts by half a limb avoid an undefined full-width shift when
+        // uintmax_t is no wider than a single limb.
+        umax = (umax << (BIGINT__LIMB_BITS_ / 2)) << (BIGINT__LIMB_BITS_ / 2);
+        umax |= bigint->limbs[i];
+    }
+
     *res = umax;
     return 0;
 }
@@ -1837,17 +2052,29 @@ bigint_to_smax(intmax_t* res, struct bigint const* bigint)
     assert(res != NULL);
     assert(bigint != NULL);
 
-    char* const cstr = bigint_to_new_cstr(bigint);
-    errno = 0;
-    intmax_t smax = strtoimax(cstr, NULL, 0);
-    int const err = errno; // save errno
-    xalloc(cstr, XALLOC_FREE);
-    assert(err == 0 || err == ERANGE);
-    if (err == ERANGE) {
+    struct bigint MAG = {0};
+    bigint_abs(&MAG, bigint);
+    uintmax_t magnitude = 0;
+    int const err = bigint_to_umax(&magnitude, &MAG);
+    bigint__fini_(&MAG);
+    if (err) {
         return -1;
     }
 
-    *res = smax;
+    if (bigint->sign < 0) {
+        if (magnitude > (uintmax_t)INTMAX_MAX + 1u) {
+            return -1;
+        }
+        *res = magnitude == (uintmax_t)INTMAX_MAX + 1u
+            ? INTMAX_MIN
+            : -(intmax_t)magnitude;
+        return 0;
+    }
+
+    if (magnitude > (uintmax_t)INTMAX_MAX) {
+        return -1;
+    }
+    *res = (intmax_t)magnitude;
     return 0;
 }
 
@@ -1886,51 +2113,47 @@ bigint_to_new_cstr(struct bigint const* self)
 {
     assert(self != NULL);
 
-    void* cstr = NULL;
-    size_t cstr_size = 0;
-
-    // Prefix
-    if (self->sign == -1) {
-        xalloc_append(&cstr, &cstr_size, "-", 1);
-    }
-
-    // Digits
-    void* digits = NULL;
-    size_t digits_size = 0;
-    char digit_buf[BIGINT__LIMB_BITS_ + STR_LITERAL_COUNT("\0")] = {0};
+    // Fast path for integers whose magnitude fits within a uintmax_t, which
+    // includes every integer value of a sized Sunder integer type.
+    uintmax_t umax = 0;
+    struct bigint const MAG = {
+        .sign = self->sign * self->sign,
+        .limbs = self->limbs,
+        .count = self->count,
+    };
+    if (bigint_to_umax(&umax, &MAG) == 0) {
+        return cstr_new_fmt("%s%ju", self->sign == -1 ? "-" : "", umax);
+    }
+
+    // Every 32-bit limb contributes fewer than ten decimal digits, so the
+    // digit buffer is sized up front and filled from the least significant
+    // end, one chunk of BIGINT__DEC_CHUNK_DIGITS_ digits per division pass.
+    size_t const size = STR_LITERAL_COUNT("-") + self->count * 10
+        + STR_LITERAL_COUNT("\0");
+    char* const buf = xalloc(NULL, size);
+    char* cur = buf + size;
+    *--cur = '\0';
 
-    struct bigint DEC = {0};
     struct bigint SELF = {0};
     bigint_abs(&SELF, self);
-    while (bigint_cmp(&SELF, BIGINT_ZERO) != 0) {
-        bigint_divrem(&SELF, &DEC, &SELF, BIGINT_DEC);
-        assert(DEC.count <= 1);
-        assert(DEC.limbs == NULL || DEC.limbs[0] < 10);
-        sprintf(digit_buf, "%d", DEC.limbs != NULL ? (int)DEC.limbs[0] : 0);
-        xalloc_prepend(&digits, &digits_size, digit_buf, strlen(digit_buf));
-    }
-    bigint__fini_(&DEC);
-    bigint__fini_(&SELF);
-
-    if (digits_size != 0) {
-        // Remove leading zeros.
-        size_t z = 0;
-        while (z < digits_size && (((char*)digits)[z] == '0')) {
-            z += 1;
+    while (SELF.sign != 0) {
+        uint32_t chunk = bigint__divrem_small_(&SELF, BIGINT__DEC_CHUNK_);
+        for (size_t i = 0; i < BIGINT__DEC_CHUNK_DIGITS_; ++i) {
+            *--cur = (char)('0' + chunk % 10);
+            chunk /= 10;
+            if (SELF.sign == 0 && chunk == 0) {
+                break; // No leading zeros on the most significant chunk.
+            }
         }
-        digits_size -= z;
-        memmove(digits, (char*)digits + z, digits_size);
     }
-    else {
-        // The number zero contains one digit - zero.
-        xalloc_append(&digits, &digits_size, "0", 1);
+    bigint__fini_(&SELF);
+    if (self->sign == -1) {
+        *--cur = '-';
     }
 
-    xalloc_append(&cstr, &cstr_size, digits, digits_size);
-    xalloc_append(&cstr, &cstr_size, "\0", 1);
-    xalloc(digits, XALLOC_FREE);
-
-    return cstr;
+    size_t const count = (size_t)(buf + size - cur);
+    memmove(buf, cur, count);
+    return buf;
 }
 
 // Byte string with guaranteed NUL termination.
@@ -2120,11 +2343,15 @@ string_split(
 
 // List of heap-allocated frozen pointers.
 sbuf(void*) frozen;
+// Guards the frozen list, which may be appended to by multiple threads.
+static pthread_mutex_t frozen_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 void
 freeze(void* ptr)
 {
+    (void)pthread_mutex_lock(&frozen_mutex);
     sbuf_push(frozen, ptr);
+    (void)pthread_mutex_unlock(&frozen_mutex);
 }
 
 void
@@ -2200,6 +2427,103 @@ source_line_end(char const* ptr)
     return ptr;
 }
 
+// Thread-specific recovery point of the active call to `speculate`, if any.
+static pthread_key_t speculation_key;
+static pthread_once_t speculation_key_once = PTHREAD_ONCE_INIT;
+
+static void
+speculation_key_create(void)
+{
+    // Diagnostics are routed through the speculation key, so failure to create
+    // the key cannot be reported with `fatal`.
+    if (pthread_key_create(&speculation_key, NULL) != 0) {
+        fprintf(stderr, "[%s] Failed to create thread key\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+}
+
+bool
+speculate(void (*fn)(void*), void* arg)
+{
+    assert(fn != NULL);
+
+    (void)pthread_once(&speculation_key_once, speculation_key_create);
+
+    // Calls to `speculate` may be nested, in which case the recovery point of
+    // the enclosing call is restored when this call returns.
+    void* const enclosing = pthread_getspecific(speculation_key);
+    jmp_buf env;
+    if (setjmp(env) != 0) {
+        (void)pthread_setspecific(speculation_key, enclosing);
+        return false;
+    }
+    (void)pthread_setspecific(speculation_key, &env);
+    fn(arg);
+    (void)pthread_setspecific(speculation_key, enclosing);
+    return true;
+}
+
+struct parallel_for_state {
+    void (*fn)(void*, size_t);
+    void* arg;
+    size_t count;
+    size_t next;
+    pthread_mutex_t mutex;
+};
+
+static void*
+parallel_for_worker(void* state_)
+{
+    struct parallel_for_state* const state = state_;
+    while (true) {
+        (void)pthread_mutex_lock(&state->mutex);
+        size_t const index = state->next;
+        state->next += index < state->count;
+        (void)pthread_mutex_unlock(&state->mutex);
+        if (index >= state->count) {
+            return NULL;
+        }
+        state->fn(state->arg, index);
+    }
+}
+
+void
+parallel_for(size_t count, void (*fn)(void*, size_t), void* arg)
+{
+    assert(fn != NULL);
+
+    long const online = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = online > 0 ? (size_t)online : 1;
+    nthreads = nthreads < count ? nthreads : count;
+
+    struct parallel_for_state state;
+    state.fn = fn;
+    state.arg = arg;
+    state.count = count;
+    state.next = 0;
+    if (pthread_mutex_init(&state.mutex, NULL) != 0) {
+        fatal(NO_LOCATION, "[%s] Failed to initialize mutex", __func__);
+    }
+
+    // The calling thread acts as one of the workers. If a thread cannot be
+    // created then the remaining work is performed by the threads that were.
+    sbuf(pthread_t) threads = NULL;
+    for (size_t i = 1; i < nthreads; ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, parallel_for_worker, &state) != 0) {
+            break;
+        }
+        sbuf_push(threads, thread);
+    }
+    (void)parallel_for_worker(&state);
+    for (size_t i = 0; i < sbuf_count(threads); ++i) {
+        (void)pthread_join(threads[i], NULL);
+    }
+
+    sbuf_fini(threads);
+    (void)pthread_mutex_destroy(&state.mutex);
+}
+
 static void
 messagev(
     bool show_template_instantiation_stack,
@@ -2213,6 +2537,15 @@ messagev(
     assert(level_ansi != NULL);
     assert(fmt != NULL);
 
+    // Abandon speculative work instead of reporting the diagnostic. The work
+    // will be redone non-speculatively, at which point the diagnostic is
+    // reported in its usual order.
+    (void)pthread_once(&speculation_key_once, speculation_key_create);
+    jmp_buf* const env = pthread_getspecific(speculation_key);
+    if (env != NULL) {
+        longjmp(*env, 1);
+    }
+
     bool const is_tty = isatty(STDERR_FILENO);
 
     if (location.path != NO_PATH || location.line != NO_LINE) {